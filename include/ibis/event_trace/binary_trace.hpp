@@ -0,0 +1,22 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#pragma once
+
+#include <iosfwd>
+
+namespace ibis::tool::event_trace {
+
+///
+/// Convert the binary trace, written by TraceLog with output_format::BINARY, into Chrome's JSON
+/// trace format. The result is the same as TraceLog writes with output_format::JSON.
+///
+/// @param in The binary trace stream, opened in binary mode.
+/// @param out The JSON stream.
+/// @throw std::runtime_error on malformed or truncated input.
+///
+void binary_to_json(std::istream& in, std::ostream& out);
+
+}  // namespace ibis::tool::event_trace
@@ -6,22 +6,38 @@
 #pragma once
 
 #include <ibis/event_trace/detail/platform.hpp>
+#include <ibis/event_trace/detail/fnv1a.hpp>
+#include <ibis/event_trace/detail/glob_matcher.hpp>
+#include <ibis/event_trace/detail/segmented_array.hpp>
 
 #include <cassert>
 #include <vector>
+#include <array>
 #include <string_view>
-#include <mutex>
+#include <atomic>
+#include <shared_mutex>
 #include <tuple>
-#include <vector>
 #include <memory>
 #include <regex>
+#include <variant>
 #include <initializer_list>
 
 namespace ibis::tool::event_trace {
 
 class category_filter {
 private:
-    using value_type = std::pair<std::string_view, std::regex>;
+    ///
+    /// The compiled filter pattern, a glob_matcher by default or a std::regex on request.
+    ///
+    struct pattern {
+        std::string_view pattern_sv;  // as given, with leading '+' or '-'
+        bool enable;
+        std::variant<detail::glob_matcher, std::regex> matcher;
+
+        bool operator()(std::string_view category_name) const;
+    };
+
+    using value_type = pattern;
 
     static constexpr std::size_t RESERVE_SZ = 10;
 
@@ -29,14 +45,17 @@ public:
     ///
     /// Construct a new filter object.
     ///
-    /// @param category_regex A string(view) of a comma separated list with regular expressions to
+    /// @param category_list A string(view) of a comma separated list with wildcard patterns to
     /// activate the categories. Using a leading '-' disables the matching category, otherwise it's
     /// enabled. For convenience an optional leading '+' activates the category too (which is of
-    /// course redundant). It's using the ECMAScript syntax for RE.
-    /// The regular expression can be expressed to match several times the same category in the
-    /// comma separated list, but the first match wins, discarding the later one.
+    /// course redundant). The pattern matches anywhere in the category name unless anchored with
+    /// '^' and '$', wildcards are '*', '?' and character sets '[...]', see detail::glob_matcher.
+    /// Patterns prefixed by 're:' (after the optional '+'/'-') are regular expressions using the
+    /// ECMAScript syntax, which are considerably slower.
+    /// The patterns can be expressed to match several times the same category in the comma
+    /// separated list, but the first match wins, discarding the later one.
     ///
-    category_filter(std::string_view category_regex, std::size_t size = RESERVE_SZ);
+    category_filter(std::string_view category_list, std::size_t size = RESERVE_SZ);
 
     ~category_filter() = default;
     category_filter(std::size_t size = RESERVE_SZ);
@@ -46,21 +65,21 @@ public:
     category_filter& operator=(category_filter&&) = default;
 
 public:
-    /// return the original categories RE expression string(view)
+    /// return the original categories pattern string(view)
     std::string_view list_sv() const { return categories; }
 
-    // the the number of RE filter expressions.
-    std::size_t count() const { return regex_list.size(); }
+    // the the number of filter patterns.
+    std::size_t count() const { return pattern_list.size(); }
 
-    /// check the @a category_name against the regular expression, if it shall enabled or disabled.
-    /// If default constructed, no given category_regex at construction time, it returns true to
+    /// check the @a category_name against the patterns, if it shall enabled or disabled.
+    /// If default constructed, no given category_list at construction time, it returns true to
     /// enable all given @category_name.
     ///
-    /// @note The first match in the regex list wins. This means that the first match in the regex
+    /// @note The first match in the pattern list wins. This means that the first match in the
     /// pattern list within the category activates/deactivates it, regardless of further entries
     /// that might give different results for that category.
     ///
-    /// @param category_name Name of the category to test against the RE stored.
+    /// @param category_name Name of the category to test against the patterns stored.
     /// @return std::pair<bool, bool> Pair of <match, enable>, if pattern matches 1st boolean is
     /// true and if enabled the 2nd is also true. otherwise false.
     ///
@@ -68,8 +87,8 @@ public:
 
     /// Syntactical sugar for matches.
     ///
-    /// @param category_name Name of the category to test against the RE stored.
-    /// @return true If the RE matches and category is enabled.
+    /// @param category_name Name of the category to test against the patterns stored.
+    /// @return true If a pattern matches and category is enabled.
     /// @return false otherwise.
     ///
     bool operator()(std::string_view category_name) const
@@ -80,14 +99,23 @@ public:
 
 private:
     std::string_view categories;
-    std::vector<value_type> regex_list;
+    std::vector<value_type> pattern_list;
 };
 
 // new concept/API https://coliru.stacked-crooked.com/a/a164f90675e3cd1c
+///
+/// Registry of the trace categories.
+///
+/// The categories are kept in a hash table of lock-free singly linked bucket chains, hence lookup
+/// and first-use registration take constant time and don't serialize the calling threads. Only
+/// the registration of a new category takes the filter lock shared to evaluate the category
+/// filter. The entries are stored in a segmented array, which grows without locking and never
+/// moves them, so the number of categories is limited by memory only and proxies stay valid.
+///
 class category {
 private:
     category();
-    ~category() = default;
+    ~category();
 
 public:
     using value_type = std::pair<std::string_view, bool>;
@@ -95,6 +123,9 @@ public:
     class entry;
     using filter = category_filter;
 
+    /// Assumed cache line size to align the entries.
+    static constexpr std::size_t CACHE_LINE_SZ = 64;
+
 public:
     static category& instance()
     {
@@ -104,7 +135,8 @@ public:
 
 public:
     /// Initialize and append a given @a categories list to the internal category list. The
-    /// initializer list is of pairs of category name and boolean enable state.
+    /// initializer list is of pairs of category name and boolean enable state. Categories already
+    /// known keep their state.
     void append(std::initializer_list<value_type> categories);
 
 public:
@@ -114,17 +146,24 @@ public:
     /// enabled state.
     static category::proxy get(std::string_view category_name);
 
+    /// Same as above with the @a hash of the @a category_name given by detail::fnv1a(), e.g.
+    /// computed at compile time by the trace macros.
+    static category::proxy get(std::string_view category_name, std::uint64_t hash);
+
 public:
     /// Get set of known categories. This can change as new code paths are reached.
     /// @todo [C++20] This is a use case [iterator_facade in C++20](
     ///  https://vector-of-bool.github.io/2020/06/13/cpp20-iter-facade.html)
     std::vector<std::string_view> GetKnownCategories() const;
 
-    std::size_t GetKnownCategoriesCount() const { return my_categories.size(); }
+    std::size_t GetKnownCategoriesCount() const
+    {
+        return category_count.load(std::memory_order_relaxed);
+    }
 
-    /// FixMe: description obsolete; Enable tracing for provided list of category. If tracing is
-    /// already enabled, this method does nothing -- changing categories during trace is not
-    /// supported. Regular expressions are supported.
+    /// Enable tracing for provided list of category, see category_filter. The categories can be
+    /// switched on and off at any time, also while tracing is running; events of a category
+    /// already recorded are kept.
     ///
     /// @param categories is a comma-delimited list of category wildcards.
     void SetEnabled(std::string_view categories);
@@ -136,69 +175,96 @@ public:
     static void dump(std::ostream& os);
 
 private:
-    category::proxy get_proxy(std::string_view name);
+    category::proxy get_proxy(std::string_view name, std::uint64_t hash);
+
+    /// Lookup the entry of @a name in the bucket chain starting at @a head, nullptr if not found.
+    static category::entry const* find(category::entry const* head, std::string_view name,
+                                       std::uint64_t hash);
+
+    /// Insert a new entry into the registry, or return the one inserted concurrently before.
+    category::entry const& insert(value_type pair, std::uint64_t hash);
+
+    /// Call @a func for each entry of the registry.
+    template <typename FuncT>
+    void for_each(FuncT&& func) const;
 
     void apply_filter();
 
 private:
-    static constexpr std::size_t MAX_CATEGORIES = 100;
+    /// Number of hash buckets, must be power of 2.
+    static constexpr std::size_t BUCKET_COUNT = 1024;
 
 private:
-    /// FixMe: std::recursive_mutex required???
-    std::mutex mutable mutex;
-
-    static inline std::vector<category::entry> my_categories;
+    /// Guards the category filter. The filter is read on registration of new categories only,
+    /// exclusive access is required to replace and apply the filter.
+    std::shared_mutex mutable filter_mutex;
 
     category::filter category_filter_;
 
-    std::vector<category::entry> category_pattern;
+    std::array<std::atomic<category::entry*>, BUCKET_COUNT> buckets = {};
+
+    /// Storage of the entries, also of those lost a concurrent insertion race.
+    detail::segmented_array<category::entry> entries;
+
+    /// Number of entries linked into the buckets.
+    std::atomic<std::size_t> category_count = 0;
 };
 
-class category::entry {
-    friend category::proxy;
+///
+/// The category's registry entry.
+///
+/// The enable state is an atomic byte, changed by SetEnabled() at any time while tracing. Each
+/// entry is aligned to its own cache line, hence toggling a category doesn't invalidate the cache
+/// line of the other categories' state. All other members are immutable once the entry is
+/// published.
+///
+class alignas(category::CACHE_LINE_SZ) category::entry {
+    friend category;
 
 public:
     using value_type = category::value_type;
 
 public:
-    entry(value_type pair)
-        : data(std::move(pair))
+    entry(value_type pair, std::uint64_t hash_)
+        : enabled_(pair.second)
+        , name(pair.first)
+        , hash(hash_)
     {
     }
 
     ~entry() = default;
-    entry(entry&&) = default;
-    entry& operator=(entry&&) = default;
 
     entry() = delete;
-    entry(const entry&) = default;
-    entry& operator=(const entry&) = delete;
+    entry(entry const&) = delete;
+    entry& operator=(entry const&) = delete;
+    entry(entry&&) = delete;
+    entry& operator=(entry&&) = delete;
 
 public:
     /// get the category name.
-    std::string_view category_name() const { return data.first; }
+    std::string_view category_name() const { return name; }
 
     /// get category name's active state.
-    explicit operator bool() const { return data.second; }
+    explicit operator bool() const { return enabled(); }
 
     /// get category name's active state.
-    bool enabled() const { return data.second; }
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
 
     /// enable the category entry
-    void enable(bool enabled) { data.second = enabled; }
+    void enable(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
 
 private:
-    value_type data;
+    std::atomic<bool> enabled_;
+    std::string_view const name;
+    std::uint64_t const hash;
+    category::entry* next = nullptr;  // bucket chain, immutable after publishing the entry
 };
 
 // Concept: https://coliru.stacked-crooked.com/a/131880fa10af40c1
 class category::proxy {
-public:
-    using value_type = std::pair<std::string_view, bool const&>;
-
 public:
     proxy(category::entry const& entry)
-        : data(entry.data.first, entry.data.second)
+        : entry_(&entry)
     {
     }
 
@@ -213,21 +279,38 @@ public:
 
 public:
     /// get the category name.
-    std::string_view category_name() const { return data.first; }
+    std::string_view category_name() const { return entry_->category_name(); }
 
     /// get category name's active state.
-    explicit operator bool() const { return data.second; }
+    explicit operator bool() const { return entry_->enabled(); }
 
     /// get category name's active state.
-    bool enabled() const { return data.second; }
+    bool enabled() const { return entry_->enabled(); }
 
 private:
-    value_type const data;
+    category::entry const* const entry_;
 };
 
 inline category::proxy category::get(std::string_view name)
 {
-    return category::instance().get_proxy(name);
+    return category::instance().get_proxy(name, detail::fnv1a(name));
+}
+
+inline category::proxy category::get(std::string_view name, std::uint64_t hash)
+{
+    assert(hash == detail::fnv1a(name) && "hash doesn't match the category name");
+    return category::instance().get_proxy(name, hash);
+}
+
+template <typename FuncT>
+inline void category::for_each(FuncT&& func) const
+{
+    for (auto const& bucket : buckets) {
+        for (auto* entry = bucket.load(std::memory_order_acquire); entry != nullptr;
+             entry = entry->next) {
+            func(*entry);
+        }
+    }
 }
 
 }  // namespace ibis::tool::event_trace
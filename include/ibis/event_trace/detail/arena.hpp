@@ -0,0 +1,109 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cassert>
+
+namespace ibis::tool::event_trace::detail {
+
+///
+/// Bump pointer allocator for the string data copied by TraceLog::copy.
+///
+/// Memory is taken from blocks of BLOCK_SZ bytes, requests larger than a block get a block of
+/// their own. There is no deallocation of single allocations, instead the whole arena is reset at
+/// once. Blocks of the default size are kept on reset for reuse, oversized blocks are released.
+///
+/// @note The arena isn't thread safe, it's intended to be owned by one event chunk and hence one
+/// recording thread.
+///
+class arena {
+public:
+    /// Size of the memory blocks allocated from heap.
+    static constexpr std::size_t BLOCK_SZ = 16 * 1024;
+
+public:
+    arena() = default;
+    ~arena() = default;
+
+    arena(arena const&) = delete;
+    arena& operator=(arena const&) = delete;
+    arena(arena&&) = default;
+    arena& operator=(arena&&) = default;
+
+public:
+    /// Get @a size bytes of uninitialized memory aligned to @a align (power of 2, at most
+    /// the alignment of operator new), valid until reset().
+    char* allocate(std::size_t size, std::size_t align = 1)
+    {
+        assert(std::has_single_bit(align) && align <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+
+        offset = (offset + align - 1) & ~(align - 1);
+
+        if (blocks.empty() || offset + size > blocks[current].size) {
+            next_block(size);
+        }
+
+        char* const ptr = blocks[current].data.get() + offset;
+        offset += size;
+        return ptr;
+    }
+
+    /// Release all allocations at once.
+    void reset()
+    {
+        std::erase_if(blocks, [](block const& blk) { return blk.size != BLOCK_SZ; });
+        current = 0;
+        offset = 0;
+    }
+
+    /// Sum of the memory blocks' size.
+    std::size_t capacity() const
+    {
+        std::size_t size = 0;
+        for (auto const& blk : blocks) {
+            size += blk.size;
+        }
+        return size;
+    }
+
+private:
+    /// Advance to the next block able to hold @a size bytes, allocate one if there is none.
+    void next_block(std::size_t size)
+    {
+        if (!blocks.empty()) {
+            while (++current < blocks.size()) {
+                if (size <= blocks[current].size) {
+                    offset = 0;
+                    return;
+                }
+            }
+        }
+
+        auto const block_size = std::max(size, BLOCK_SZ);
+        // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+        blocks.push_back(block{ std::make_unique_for_overwrite<char[]>(block_size), block_size });
+        current = blocks.size() - 1;
+        offset = 0;
+    }
+
+private:
+    struct block {
+        //NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+        std::unique_ptr<char[]> data;
+        std::size_t size;
+    };
+
+    std::vector<block> blocks;
+    std::size_t current = 0;  // index of the block in use
+    std::size_t offset = 0;   // bump pointer into the current block
+};
+
+}  // namespace ibis::tool::event_trace::detail
@@ -0,0 +1,63 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#pragma once
+
+#include <string_view>
+#include <cstdint>
+
+///
+/// Compact binary trace format.
+///
+/// The stream starts with the MAGIC and the VERSION byte, followed by records. Each record starts
+/// with its tag byte:
+///
+/// - STRING: varint ID, varint length, bytes. Defines the string table's entry with the next ID,
+///   the category, event and argument names are written once and referred by their ID.
+/// - THREAD: signed varint process ID, signed varint thread ID. The events following are
+///   recorded by this thread.
+/// - EVENT: phase byte, flags byte, varint category ID, varint name ID, signed varint time stamp
+///   delta to the previous event in nanoseconds, [varint duration in nanoseconds if COMPLETE],
+///   [varint trace ID if HAS_ID], [signed varint thread ID if HAS_TID], varint argument count
+///   and the arguments: varint name ID, type byte (trace_value::type) and the typed value.
+/// - END: end of trace session.
+///
+/// Values are encoded as LEB128 varint, signed values as zigzag varint, doubles as 8 byte little
+/// endian and string values inline as varint length and bytes.
+///
+namespace ibis::tool::event_trace::detail::binary_format {
+
+inline constexpr std::string_view MAGIC = "IBTR";
+inline constexpr std::uint8_t VERSION = 1;
+
+/// Record tags.
+enum class record : std::uint8_t {
+    STRING = 1,
+    THREAD = 2,
+    EVENT = 3,
+    END = 4
+};
+
+/// Flags of the EVENT record.
+enum event_flag : std::uint8_t {
+    NONE = 0,
+    HAS_ID = 1U << 0U,   ///< trace ID follows
+    HAS_TID = 1U << 1U,  ///< recorded for another thread, e.g. thread name metadata
+};
+
+/// Maximal size of a 64-bit varint.
+inline constexpr std::size_t MAX_VARINT_SZ = 10;
+
+constexpr std::uint64_t zigzag_encode(std::int64_t value)
+{
+    return (static_cast<std::uint64_t>(value) << 1U) ^ static_cast<std::uint64_t>(value >> 63U);
+}
+
+constexpr std::int64_t zigzag_decode(std::uint64_t value)
+{
+    return static_cast<std::int64_t>(value >> 1U) ^ -static_cast<std::int64_t>(value & 1U);
+}
+
+}  // namespace ibis::tool::event_trace::detail::binary_format
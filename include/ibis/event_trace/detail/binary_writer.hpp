@@ -0,0 +1,114 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#pragma once
+
+#include <ibis/event_trace/detail/binary_format.hpp>
+#include <ibis/event_trace/detail/trace_value.hpp>
+#include <ibis/event_trace/detail/string_table.hpp>
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+namespace ibis::tool::event_trace::detail {
+
+///
+/// Writer of the compact binary format, see @ref binary_format.
+///
+/// The writer lives for one trace session, it keeps the string table and the time stamp of the
+/// previous event. The records are appended to the writer's buffer, which is handed to the
+/// output callback and cleared by the caller. Each buffer contains whole records only.
+///
+class binary_writer {
+public:
+    binary_writer() = default;
+    ~binary_writer() = default;
+
+    binary_writer(binary_writer const&) = delete;
+    binary_writer& operator=(binary_writer const&) = delete;
+    binary_writer(binary_writer&&) = delete;
+    binary_writer& operator=(binary_writer&&) = delete;
+
+public:
+    std::string_view data() const { return out; }
+
+    void clear() { out.clear(); }
+
+    void reserve(std::size_t size) { out.reserve(size); }
+
+public:
+    /// Append the stream's magic and version.
+    void header();
+
+    /// Append the END record.
+    void footer();
+
+    /// Append the THREAD record, if the thread differs from the previous one.
+    void thread(std::int64_t process_id, std::int64_t thread_id);
+
+    /// Get the string table's ID of @a str, a STRING record is appended for new strings. Hence
+    /// all IDs of a record have to be get before the record is started.
+    std::uint64_t string_id(std::string_view str)
+    {
+        auto const [id, inserted] = strings.insert(str);
+        if (inserted) {
+            string_record(id, str);
+        }
+        return id;
+    }
+
+    /// Clear the string table's cache of string addresses, see string_table::clear_cache().
+    void clear_cache() { strings.clear_cache(); }
+
+public:
+    /// Start the record of @a tag.
+    void record(binary_format::record tag) { byte(static_cast<std::uint8_t>(tag)); }
+
+    void byte(std::uint8_t value) { out.push_back(static_cast<char>(value)); }
+
+    void varint(std::uint64_t value)
+    {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7FU) | 0x80U));
+            value >>= 7U;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    void signed_varint(std::int64_t value) { varint(binary_format::zigzag_encode(value)); }
+
+    /// Append the time stamp @a time_ns as delta to the previous one.
+    void timestamp(std::int64_t time_ns)
+    {
+        signed_varint(time_ns - last_timestamp);
+        last_timestamp = time_ns;
+    }
+
+    /// Append the string inline, as length and bytes.
+    void bytes(std::string_view str)
+    {
+        varint(str.size());
+        out.append(str);
+    }
+
+    /// Append the type and the value of the argument.
+    void value(trace_value const& value);
+
+private:
+    void string_record(std::uint64_t id, std::string_view str);
+
+private:
+    std::string out;
+
+    string_table strings;
+
+    std::int64_t last_timestamp = 0;
+    std::int64_t last_process_id = 0;
+    std::int64_t last_thread_id = 0;
+    bool has_thread = false;
+};
+
+}  // namespace ibis::tool::event_trace::detail
@@ -0,0 +1,61 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#pragma once
+
+#include <string_view>
+#include <algorithm>
+
+namespace ibis::tool::event_trace::detail {
+
+///
+/// Check at compile time if the @a category_name is listed in the comma separated @a list of
+/// category names.
+///
+/// An entry matches the category name exactly, an entry with trailing '*' matches all category
+/// names starting with the prefix in front of the '*'. White spaces around the entries are
+/// ignored. E.g. the list "debug, gui.*" matches the categories "debug", "gui.render" and
+/// "gui.input", but not "debugger".
+///
+/// @param list The comma separated list of names and prefixes.
+/// @param category_name Name of the category to look for.
+/// @return true if the name is listed.
+///
+constexpr bool category_listed(std::string_view list, std::string_view category_name)
+{
+    constexpr std::string_view whitespace = " \t";
+
+    while (!list.empty()) {
+        auto const comma_pos = list.find(',');
+        auto entry = list.substr(0, comma_pos);
+        list = (comma_pos == std::string_view::npos) ? std::string_view{}
+                                                      : list.substr(comma_pos + 1);
+
+        // trim white spaces
+        entry.remove_prefix(std::min(entry.find_first_not_of(whitespace), entry.size()));
+        if (auto const last = entry.find_last_not_of(whitespace);
+            last != std::string_view::npos) {
+            entry = entry.substr(0, last + 1);
+        }
+
+        if (entry.empty()) {
+            continue;
+        }
+
+        if (entry.back() == '*') {
+            entry.remove_suffix(1);
+            if (category_name.starts_with(entry)) {
+                return true;
+            }
+        }
+        else if (category_name == entry) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+}  // namespace ibis::tool::event_trace::detail
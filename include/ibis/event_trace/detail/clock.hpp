@@ -5,7 +5,20 @@
 
 #pragma once
 
+#include <ibis/event_trace/detail/config.hpp>
+
 #include <chrono>
+#include <concepts>
+#include <type_traits>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define IBIS_TRACE_EVENT_HAS_RDTSC
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define IBIS_TRACE_EVENT_HAS_RDTSC
+#endif
 
 namespace ibis::tool::event_trace::clock {
 
@@ -13,6 +26,10 @@ using clock_type = std::chrono::steady_clock;
 using time_point_type = clock::clock_type::time_point; //std::chrono::time_point<clock_type>;
 using duration_type = clock::time_point_type::duration;
 
+/// Raw count of the clock source as recorded by the trace events, the conversion to a time point
+/// or duration is done at flush time.
+using tick_type = std::uint64_t;
+
 /// Convenience value for no duration to initialize the timestamp in TraceEvent with the
 /// correct type.
 static inline constexpr auto time_point_zero =
@@ -21,13 +38,186 @@ static inline constexpr auto time_point_zero =
 /// Convenience value for threshold's duration.
 static inline constexpr auto duration_zero = clock_type::duration::zero();
 
+///
+/// Clock reading the CPU's time stamp counter (TSC).
+///
+/// Reading the TSC takes a few CPU cycles, compared to the vDSO call of clock_gettime() behind
+/// std::chrono::steady_clock. The TSC is calibrated once against std::chrono::steady_clock on
+/// first use, see init(); its ticks are mapped to the steady clock's time points. Only with
+/// invariant TSC support of the CPU the tick rate is constant and synchronized over all cores,
+/// otherwise (and on non x86 targets) the ticks are the nanoseconds of std::chrono::steady_clock.
+///
+struct tsc_clock {
+    using duration = clock::duration_type;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = clock::time_point_type;
+
+    static constexpr bool is_steady = true;
+
+    /// Raw tick count.
+    static tick_type ticks() noexcept
+    {
+        if (calibration().use_tsc) {
+            return read_tsc();
+        }
+        return static_cast<tick_type>(clock_type::now().time_since_epoch().count());
+    }
+
+    static time_point now() noexcept { return to_time_point(ticks()); }
+
+    static time_point to_time_point(tick_type ticks) noexcept
+    {
+        auto const& calib = calibration();
+        if (!calib.use_tsc) {
+            return time_point(duration(static_cast<rep>(ticks)));
+        }
+        // signed, the ticks may be recorded before calibration's base
+        auto const delta = static_cast<std::int64_t>(ticks - calib.base_ticks);
+        return calib.base_time + duration(static_cast<rep>(
+                                     static_cast<double>(delta) * calib.ns_per_tick));
+    }
+
+    static duration to_duration(tick_type ticks) noexcept
+    {
+        auto const& calib = calibration();
+        if (!calib.use_tsc) {
+            return duration(static_cast<rep>(ticks));
+        }
+        return duration(static_cast<rep>(static_cast<double>(ticks) * calib.ns_per_tick));
+    }
+
+    static tick_type to_ticks(duration dur) noexcept
+    {
+        auto const& calib = calibration();
+        if (!calib.use_tsc) {
+            return static_cast<tick_type>(dur.count());
+        }
+        return static_cast<tick_type>(static_cast<double>(dur.count()) / calib.ns_per_tick);
+    }
+
+    /// True if the TSC is used, false on fall back to std::chrono::steady_clock.
+    static bool is_tsc() noexcept { return calibration().use_tsc; }
+
+    /// Calibrate the TSC ahead of the first time stamp, which would take the calibration's time
+    /// otherwise.
+    static void init() noexcept { calibration(); }
+
+private:
+    static_assert(std::is_same_v<period, std::nano>, "steady_clock's ticks are expected in ns");
+
+    struct calibration_type {
+        bool use_tsc = false;
+        tick_type base_ticks = 0;
+        time_point base_time = time_point_zero;
+        double ns_per_tick = 1.0;
+    };
+
+    /// Calibrated once on first use, see calibrate().
+    static calibration_type const& calibration() noexcept
+    {
+        static calibration_type const calib = calibrate();
+        return calib;
+    }
+
+    /// Check for invariant TSC support and measure the TSC's rate against the steady clock.
+    static calibration_type calibrate() noexcept;
+
+    /// Read the TSC, without serializing (rdtscp or fences), since the order of events recorded
+    /// by a thread is given by the memory order of their chunk.
+    static tick_type read_tsc() noexcept
+    {
+#if defined(IBIS_TRACE_EVENT_HAS_RDTSC)
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+};
+
+#if IBIS_TRACE_EVENT_TSC_CLOCK
+using default_clock_type = tsc_clock;
+#else
+using default_clock_type = clock_type;
+#endif
+
+///
+/// Clock with own raw tick count, which must be converted into time points and durations.
+///
+template<typename clock_impl>
+concept TickClockT = requires(tick_type ticks, duration_type dur) {
+    { clock_impl::ticks() } -> std::same_as<tick_type>;
+    { clock_impl::to_time_point(ticks) } -> std::same_as<time_point_type>;
+    { clock_impl::to_duration(ticks) } -> std::same_as<duration_type>;
+    { clock_impl::to_ticks(dur) } -> std::same_as<tick_type>;
+};
+
 ///
 /// clock source for generating time stamps.
 ///
+/// The trace events record the clock's ticks(), which are converted by to_time_point() and
+/// to_duration() on flush. For std::chrono like clocks the ticks are simply the nanoseconds since
+/// the clock's epoch.
+///
 /// @see Concept [Coliru](https://coliru.stacked-crooked.com/a/9374003ad8dc61c8)
-template<typename clock_impl = clock_type>
+template<typename clock_impl = default_clock_type>
 struct time {
+    /// Initialize the clock source, if required, e.g. the TSC's calibration.
+    static void init() noexcept
+    {
+        if constexpr (requires { clock_impl::init(); }) {
+            clock_impl::init();
+        }
+    }
+
     static time_point_type now() noexcept { return clock_impl::now(); }
+
+    static tick_type ticks() noexcept
+    {
+        if constexpr (TickClockT<clock_impl>) {
+            return clock_impl::ticks();
+        }
+        else {
+            return static_cast<tick_type>(to_ns(clock_impl::now().time_since_epoch()));
+        }
+    }
+
+    static time_point_type to_time_point(tick_type ticks) noexcept
+    {
+        if constexpr (TickClockT<clock_impl>) {
+            return clock_impl::to_time_point(ticks);
+        }
+        else {
+            return time_point_type(std::chrono::nanoseconds(ticks));
+        }
+    }
+
+    static duration_type to_duration(tick_type ticks) noexcept
+    {
+        if constexpr (TickClockT<clock_impl>) {
+            return clock_impl::to_duration(ticks);
+        }
+        else {
+            return std::chrono::nanoseconds(ticks);
+        }
+    }
+
+    static tick_type to_ticks(duration_type dur) noexcept
+    {
+        if constexpr (TickClockT<clock_impl>) {
+            return clock_impl::to_ticks(dur);
+        }
+        else {
+            return static_cast<tick_type>(to_ns(dur));
+        }
+    }
+
+private:
+    template<typename DurationT>
+    static std::chrono::nanoseconds::rep to_ns(DurationT dur) noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(dur).count();
+    }
 };
 
 }  // namespace ibis::tool::event_trace::clock
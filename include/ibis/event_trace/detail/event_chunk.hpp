@@ -0,0 +1,211 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#pragma once
+
+#include <ibis/event_trace/trace_event.hpp>
+#include <ibis/event_trace/detail/arena.hpp>
+#include <ibis/event_trace/detail/string_pool.hpp>
+
+#include <vector>
+#include <span>
+#include <memory>
+#include <atomic>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+
+namespace ibis::tool::event_trace {
+
+///
+/// Fixed capacity event buffer owned by exactly one recording thread (single producer).
+///
+/// A thread gets its chunk from TraceLog on its first event and records into it without any
+/// locking. Once the chunk is full, outdated by a flush request or the thread exits, the chunk is
+/// handed back to TraceLog (retired), where it waits for Flush(). After flushing, the chunk is
+/// recycled to the free pool.
+///
+/// The event's arguments and the string data copied by TraceLog::copy are stored in the chunk's
+/// arena, which is released at once on recycling.
+///
+/// The chunk holds the full time stamp of its first event as base time, the events store their
+/// time stamps as 32-bit delta to it. The complete events are recorded at their end, hence the
+/// events of a thread are ordered by time usually. The full time stamp of an event not fitting
+/// into the delta range is stored in the event's side area, see fits().
+///
+/// The count of recorded events is published atomically, so other threads may read it (e.g. to
+/// compute the buffer fill level) while the owning thread is still recording. Flush() uses this to
+/// serialize the published events of chunks still bound to their thread, the number of events
+/// flushed so is kept by the chunk and these events are skipped on the next flush.
+///
+class event_chunk {
+public:
+    /// Number of events a chunk can hold.
+    static constexpr std::size_t CHUNK_SZ = 1024;
+
+public:
+    event_chunk() { events.reserve(CHUNK_SZ); }
+
+    ~event_chunk() = default;
+    event_chunk(event_chunk const&) = delete;
+    event_chunk& operator=(event_chunk const&) = delete;
+    event_chunk(event_chunk&&) = delete;
+    event_chunk& operator=(event_chunk&&) = delete;
+
+public:
+    /// Bind the chunk to a (new) recording thread with @a thread_index_ of the thread registry.
+    /// The @a first_event_id is the thread's event sequence number of the first event to be
+    /// recorded into this chunk. The chunk keeps the trace session's string @a pool alive, as long
+    /// as its events may refer to it.
+    void bind(std::uint32_t generation_, std::int32_t first_event_id_,
+              thread_registry::index_type thread_index_,
+              std::shared_ptr<detail::string_pool> pool_)
+    {
+        generation = generation_;
+        first_event_id = first_event_id_;
+        thread_index = thread_index_;
+        pool = std::move(pool_);
+    }
+
+    /// Discard all events, called on recycling when the chunk hasn't an owner anymore.
+    void clear()
+    {
+        events.clear();
+        storage.reset();
+        pool.reset();
+        base_time = 0;
+        latest_time.store(0, std::memory_order_relaxed);
+        committed.store(0, std::memory_order_relaxed);
+        flushed = 0;
+        in_flush = false;
+    }
+
+public:
+    bool full() const { return events.size() == CHUNK_SZ; }
+
+    bool empty() const { return events.empty(); }
+
+    /// Check if an event at @a timestamp can be recorded relative to the chunk's base time, also
+    /// false for time stamps before the base time. Otherwise the event is recorded with flag
+    /// TraceEvent::flag::FULL_TIME and its time stamp is stored in the side area.
+    bool fits(clock::tick_type timestamp) const
+    {
+        return events.empty() || timestamp - base_time <= MAX_TIME_DELTA;
+    }
+
+    /// Number of events recorded, may be called from any thread.
+    std::size_t size() const { return committed.load(std::memory_order_acquire); }
+
+    /// The generation of TraceLog at the time the chunk was bound to its thread.
+    std::uint32_t bound_generation() const { return generation; }
+
+    /// Number of events already flushed, these are at the chunk's begin. Guarded by TraceLog's
+    /// lock.
+    std::size_t flushed_count() const { return flushed; }
+
+    void set_flushed_count(std::size_t count) { flushed = count; }
+
+    /// Set while the events of a bound chunk are serialized by Flush(), the chunk must not be
+    /// recycled even if it's handed over meanwhile. Guarded by TraceLog's lock.
+    bool flushing() const { return in_flush; }
+
+    void set_flushing(bool flushing) { in_flush = flushing; }
+
+public:
+    /// Record a new event at @a timestamp; must only be called by the owning thread. The chunk
+    /// must not be full. The time stamp not fitting is taken from the side area, see
+    /// allocate_args().
+    template <typename... Args>
+    TraceEvent& emplace_back(clock::tick_type timestamp, Args&&... args)
+    {
+        assert(!full() && "event chunk overflow");
+
+        if (events.empty()) {
+            base_time = timestamp;
+        }
+        auto const time_delta =
+            fits(timestamp) ? static_cast<std::uint32_t>(timestamp - base_time) : 0;
+
+        // the events aren't ordered by time, e.g. if stamped explicitly by the caller
+        if (timestamp > latest_time.load(std::memory_order_relaxed)) {
+            latest_time.store(timestamp, std::memory_order_relaxed);
+        }
+
+        // The storage is reserved, hence no reallocation takes place here.
+        auto& event = events.emplace_back(time_delta, std::forward<Args>(args)...);
+        committed.store(events.size(), std::memory_order_release);
+        return event;
+    }
+
+    /// Get the thread's event sequence number of the next event to be recorded.
+    std::int32_t next_event_id() const
+    {
+        return first_event_id + static_cast<std::int32_t>(events.size());
+    }
+
+    /// The memory for the event's side data (copied strings and arguments), must only be used
+    /// by the owning thread.
+    detail::arena& side_storage() { return storage; }
+
+    /// Get the side area for @a count arguments of an event recorded at @a timestamp, must only
+    /// be used by the owning thread. If the time stamp doesn't fit, it's stored ahead of the
+    /// arguments. Returns nullptr if there is nothing to store.
+    trace_arg* allocate_args(clock::tick_type timestamp, std::size_t count)
+    {
+        static_assert(sizeof(clock::tick_type) % alignof(trace_arg) == 0,
+                      "the full time stamp must keep the arguments aligned");
+
+        std::size_t const time_size = fits(timestamp) ? 0 : sizeof(clock::tick_type);
+
+        if (count == 0 && time_size == 0) {
+            return nullptr;
+        }
+
+        char* const ptr =
+            storage.allocate(time_size + trace_arg::storage_size(count), alignof(trace_arg));
+        std::memcpy(ptr, &timestamp, time_size);
+
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        return reinterpret_cast<trace_arg*>(ptr + time_size);
+    }
+
+    /// The pool to intern the event's string data, nullptr if there is no trace session.
+    detail::string_pool* interned_strings() const { return pool.get(); }
+
+public:
+    /// Access the recorded events published by size(), may be called from any thread. The
+    /// storage is reserved, hence the events don't move while the owning thread is recording.
+    std::span<TraceEvent const> data() const { return { events.data(), size() }; }
+
+    /// The time stamp of the first event, the others are relative to.
+    clock::tick_type base() const { return base_time; }
+
+    /// The latest time stamp of the events published, may be called from any thread.
+    clock::tick_type latest() const { return latest_time.load(std::memory_order_relaxed); }
+
+    /// The registry's index of the recording thread.
+    thread_registry::index_type thread() const { return thread_index; }
+
+private:
+    static constexpr clock::tick_type MAX_TIME_DELTA = std::numeric_limits<std::uint32_t>::max();
+
+private:
+    std::vector<TraceEvent> events;
+    detail::arena storage;
+    std::shared_ptr<detail::string_pool> pool;
+    std::atomic<std::size_t> committed = 0;
+    std::atomic<clock::tick_type> latest_time = 0;
+    clock::tick_type base_time = 0;
+
+    std::uint32_t generation = 0;
+    std::int32_t first_event_id = 0;
+    thread_registry::index_type thread_index = 0;
+
+    std::size_t flushed = 0;
+    bool in_flush = false;
+};
+
+}  // namespace ibis::tool::event_trace
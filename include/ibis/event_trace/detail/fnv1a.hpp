@@ -0,0 +1,31 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#pragma once
+
+#include <string_view>
+#include <cstdint>
+
+namespace ibis::tool::event_trace::detail {
+
+///
+/// 64-bit FNV-1a hash of @a str, usable at compile time.
+///
+/// @see [FNV Hash](http://www.isthe.com/chongo/tech/comp/fnv/index.html)
+///
+constexpr std::uint64_t fnv1a(std::string_view str)
+{
+    constexpr std::uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+    constexpr std::uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+    std::uint64_t hash = FNV_OFFSET_BASIS;
+    for (char const chr : str) {
+        hash ^= static_cast<std::uint8_t>(chr);
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+}  // namespace ibis::tool::event_trace::detail
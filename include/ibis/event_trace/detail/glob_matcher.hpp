@@ -0,0 +1,76 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#pragma once
+
+#include <bitset>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+namespace ibis::tool::event_trace::detail {
+
+///
+/// Wildcard pattern matcher for category names.
+///
+/// The pattern is compiled once on construction. Like the regular expressions of category_filter,
+/// the pattern matches anywhere inside the name unless anchored:
+///
+/// - '^' at the begin anchors the pattern at the begin of the name,
+/// - '$' at the end anchors the pattern at the end of the name,
+/// - '*' matches any sequence of characters, also the empty one,
+/// - '?' matches any single character,
+/// - '[abc]', '[a-z]' matches one character of the set, '[!abc]' or '[^abc]' the negated set,
+/// - '\\' escapes the following character.
+///
+/// Patterns without wildcards are matched by plain string compare (exact, prefix, suffix or
+/// substring), all others by a linear wildcard matcher with single '*' backtracking.
+///
+class glob_matcher {
+public:
+    explicit glob_matcher(std::string_view pattern);
+
+    ~glob_matcher() = default;
+    glob_matcher(glob_matcher const&) = default;
+    glob_matcher& operator=(glob_matcher const&) = default;
+    glob_matcher(glob_matcher&&) = default;
+    glob_matcher& operator=(glob_matcher&&) = default;
+
+public:
+    /// Test the @a name against the pattern.
+    bool operator()(std::string_view name) const;
+
+private:
+    enum class kind : std::uint8_t {
+        EXACT,      ///< "^literal$"
+        PREFIX,     ///< "^literal"
+        SUFFIX,     ///< "literal$"
+        SUBSTRING,  ///< "literal"
+        WILDCARD    ///< anything else
+    };
+
+    struct element {
+        enum class type : std::uint8_t { CHAR, ANY_CHAR, CHAR_SET, ANY_STRING };
+
+        type type_;
+        char chr;             // for type::CHAR
+        std::uint16_t index;  // into char_sets for type::CHAR_SET
+    };
+
+    using char_set = std::bitset<256>;
+
+    bool match_wildcard(std::string_view name) const;
+
+    bool matches(element const& elem, char chr) const;
+
+private:
+    kind kind_ = kind::SUBSTRING;
+    std::string literal;             // kind EXACT ... SUBSTRING
+    std::vector<element> elements;   // kind WILDCARD
+    std::vector<char_set> char_sets;
+};
+
+}  // namespace ibis::tool::event_trace::detail
@@ -4,13 +4,16 @@
 #pragma once
 
 #include <ibis/event_trace/detail/trace_value.hpp>
+#include <ibis/event_trace/detail/json_writer.hpp>
 #include <ibis/event_trace/trace_event.hpp>
 #include <ibis/event_trace/trace_id.hpp>
 
-#include <ibis/util/overloaded.hpp>
-
 #include <fmt/core.h>
-#include <range/v3/view/zip.hpp>
+
+#include <string>
+#include <algorithm>
+#include <limits>
+#include <bit>
 
 namespace ibis::tool::event_trace {
 
@@ -48,27 +51,13 @@ struct formatter<event_trace::jstring> {
     template<typename FormatContext>
     auto format(event_trace::jstring str, FormatContext& ctx) {
 
-        auto const is_control = [](char chr) { return 0x00 <= chr && chr <= 0x1F; };
+        // same escaping as used for the trace event's JSON output, written in place
+        auto out = ctx.out();
+        event_trace::detail::json_writer::escape(str.contents, [&out](std::string_view run) {
+            out = std::copy(run.begin(), run.end(), out);
+        });
 
-        // format-clang off
-        for (auto const chr : str.contents) {
-            switch (chr) {
-                case '"':  fmt::format_to(ctx.out(), R"(\")"); break;
-                case '\\': fmt::format_to(ctx.out(), R"(\\)"); break;
-                case '\b': fmt::format_to(ctx.out(), R"(\b)"); break;
-                case '\f': fmt::format_to(ctx.out(), R"(\f)"); break;
-                case '\n': fmt::format_to(ctx.out(), R"(\n)"); break;
-                case '\r': fmt::format_to(ctx.out(), R"(\r)"); break;
-                case '\t': fmt::format_to(ctx.out(), R"(\t)"); break;
-                default:
-                    if (is_control(chr)) { // UNICODE
-                        fmt::format_to(ctx.out(), R"(\u{:0{}X})", static_cast<std::uint64_t>(chr), 4U);
-                    }
-                    fmt::format_to(ctx.out(), "{}", chr);
-            }
-        }
-        // format-clang on
-        return ctx.out();
+        return out;
     }
 };
 
@@ -82,35 +71,36 @@ struct formatter<event_trace::trace_value> {
     template<typename FormatContext>
     auto format(event_trace::trace_value const& value, FormatContext& ctx) {
 
-        using ibis::util::overloaded;
         using event_trace::jstring;
+        using type = event_trace::trace_value::type;
 
-        auto const null = [&]() { return fmt::format_to(ctx.out(), "null"); };
+        auto const payload = value.data();
 
         // format-clang off
-        return std::visit(overloaded{
-            [&](auto val) { // captures bool, uint64_t and int64_t
-                return fmt::format_to(ctx.out(), "{}", val);
-            },
-            [&](double val) {
-                return fmt::format_to(ctx.out(), "{:<.{}}", val, std::numeric_limits<double>::max_digits10);
-            },
-            [&](char const* cstr) {
-                if (cstr == nullptr) { return null(); }
-                return fmt::format_to(ctx.out(), R"("{}")", jstring(cstr));
-            },
-            [&](void const* ptr) {
-                if (ptr == nullptr) { return null(); }
+        switch (value.type_tag()) {
+            case type::BOOL:
+                return fmt::format_to(ctx.out(), "{}", payload.boolean);
+            case type::UINT:
+                return fmt::format_to(ctx.out(), "{}", payload.uint);
+            case type::INT:
+                return fmt::format_to(ctx.out(), "{}", payload.int_);
+            case type::DOUBLE:
+                return fmt::format_to(ctx.out(), "{:<.{}}", payload.real, std::numeric_limits<double>::max_digits10);
+            case type::STRING:
+                if (payload.str == nullptr) { break; }
+                return fmt::format_to(ctx.out(), R"("{}")", jstring(payload.str));
+            case type::POINTER:
+                if (payload.ptr == nullptr) { break; }
                 // JSON only supports double and 64-bit integers numbers. So output as a hex string.
                 // << hex(static_cast<std::uint64_t>(reinterpret_cast<std::intptr_t>(ptr)), 8)
                 // mimics fmt::ptr() to avoid to include <fmt/format.h>
-                return fmt::format_to(ctx.out(), R"("0x{}")", std::bit_cast<const void*>(ptr));
-            },
-            [&]([[maybe_unused]] std::monostate) {
-                return null();
-            }
-        }, value.data());
+                return fmt::format_to(ctx.out(), R"("0x{}")", std::bit_cast<const void*>(payload.ptr));
+            case type::NONE:
+                break;
+        }
         // format-clang on
+
+        return fmt::format_to(ctx.out(), "null");
     }
 };
 
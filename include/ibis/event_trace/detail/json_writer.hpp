@@ -0,0 +1,114 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#pragma once
+
+#include <ibis/event_trace/detail/trace_value.hpp>
+
+#include <string>
+#include <string_view>
+#include <array>
+#include <charconv>
+#include <concepts>
+#include <cstdint>
+
+namespace ibis::tool::event_trace::detail {
+
+///
+/// Minimal JSON writer, appends directly to the output string.
+///
+/// Intended for the serialization of the trace events on flush: constant fragments are appended
+/// as is, numbers are formatted by std::to_chars() and strings are quoted and escaped. There is no
+/// check of the JSON's structure, the caller is responsible for it.
+///
+/// @see
+/// - [ECMA](
+///    https://www.ecma-international.org/publications-and-standards/standards/ecma-404/)
+/// - [IETF](https://datatracker.ietf.org/doc/html/rfc7159)
+///
+class json_writer {
+public:
+    explicit json_writer(std::string& out_)
+        : out{ out_ }
+    {
+    }
+
+    ~json_writer() = default;
+    json_writer(json_writer const&) = delete;
+    json_writer& operator=(json_writer const&) = delete;
+    json_writer(json_writer&&) = delete;
+    json_writer& operator=(json_writer&&) = delete;
+
+public:
+    /// Append the @a fragment without any escaping.
+    void literal(std::string_view fragment) { out.append(fragment); }
+
+    void literal(char chr) { out.push_back(chr); }
+
+    /// Append the integer @a value.
+    template <std::integral T>
+    void number(T value)
+    {
+        std::array<char, 24> buf;  // 20 digits of uint64_t max and sign
+        auto const result = std::to_chars(buf.data(), buf.data() + buf.size(), value);
+        out.append(buf.data(), result.ptr);
+    }
+
+    /// Append the @a value in the shortest representation reading back to the same value. JSON
+    /// has no infinity and NaN, these are written as null.
+    void number(double value);
+
+    /// Append the @a value as quoted hexadecimal string with prefix "0x" and at least
+    /// @a min_digits digits, e.g. "0x0000002A".
+    void hex_string(std::uint64_t value, std::size_t min_digits = 1, bool upper_case = false);
+
+    /// Append the quoted and escaped @a str.
+    void string(std::string_view str)
+    {
+        out.push_back('"');
+        escaped(str);
+        out.push_back('"');
+    }
+
+    /// Append the escaped @a str without quotes. The characters to be escaped are searched
+    /// vectorized, the runs between them are copied at once.
+    void escaped(std::string_view str);
+
+    /// Escape @a str for other outputs than the writer's string, e.g. an output iterator. The
+    /// runs of characters not to be escaped and the escape sequences are passed in order to
+    /// @a sink as std::string_view.
+    template <typename SinkT>
+    static void escape(std::string_view str, SinkT&& sink)
+    {
+        std::size_t run_begin = 0;
+
+        for (std::size_t pos = find_escape(str, 0); pos != str.size();
+             pos = find_escape(str, run_begin)) {
+            sink(str.substr(run_begin, pos - run_begin));
+            run_begin = pos + 1;
+
+            std::array<char, 6> buf;
+            sink(escape_sequence(str[pos], buf));
+        }
+
+        sink(str.substr(run_begin));
+    }
+
+    /// Append the JSON representation of the @a value.
+    void value(trace_value const& value);
+
+private:
+    /// Position of the first character to be escaped in @a str starting at @a pos, or the size
+    /// of @a str if there is none.
+    static std::size_t find_escape(std::string_view str, std::size_t pos);
+
+    /// The escape sequence of @a chr, @a buf holds the ones of the control characters.
+    static std::string_view escape_sequence(char chr, std::array<char, 6>& buf);
+
+private:
+    std::string& out;
+};
+
+}  // namespace ibis::tool::event_trace::detail
@@ -0,0 +1,181 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#pragma once
+
+#include <ibis/event_trace/detail/trace_value.hpp>
+#include <ibis/event_trace/detail/string_table.hpp>
+
+#include <string>
+#include <string_view>
+#include <span>
+#include <vector>
+#include <utility>
+#include <unordered_set>
+#include <cstdint>
+
+namespace ibis::tool::event_trace::detail {
+
+///
+/// Writer of Perfetto's protobuf trace format, the records are TracePacket messages with
+/// TrackEvent payload, as written by Perfetto's SDK. The protobuf wire format is encoded by hand,
+/// there is no dependency on libprotobuf.
+///
+/// The Chrome JSON phases are mapped to track events:
+/// - 'B', 'E', 'I': slice begin, slice end and instant on the recording thread's track.
+/// - 'X': slice begin and end at time stamp plus duration on the thread's track.
+/// - 'S', 'T', 'F': slice begin, instant and slice end on an async track of the process, one
+///   track for each event name and ID.
+/// - 'C': a counter value for each numerical argument on the process' counter track named
+///   by the event and argument names.
+/// - 'M': the thread_name metadata updates the thread track's descriptor.
+///
+/// The category and event names and the argument names are interned per session, the thread,
+/// async and counter tracks are described once on their first use. Arguments are written as
+/// debug annotations, null strings and pointers are omitted.
+///
+/// @see [Perfetto TracePacket](https://perfetto.dev/docs/reference/trace-packet-proto)
+///
+class perfetto_writer {
+public:
+    /// Event data as given by TraceEvent.
+    struct event {
+        char phase;
+        std::string_view category_name;
+        std::string_view event_name;
+        std::int64_t timestamp;  ///< nanoseconds
+        std::int64_t duration;   ///< nanoseconds, COMPLETE only
+        std::uint64_t trace_id;
+        bool has_id;
+        std::span<std::pair<char const*, trace_value> const> args;
+    };
+
+public:
+    perfetto_writer() = default;
+    ~perfetto_writer() = default;
+
+    perfetto_writer(perfetto_writer const&) = delete;
+    perfetto_writer& operator=(perfetto_writer const&) = delete;
+    perfetto_writer(perfetto_writer&&) = delete;
+    perfetto_writer& operator=(perfetto_writer&&) = delete;
+
+public:
+    std::string_view data() const { return out; }
+
+    void clear() { out.clear(); }
+
+    void reserve(std::size_t size) { out.reserve(size); }
+
+    /// Clear the cache of the interned strings' addresses, see string_table::clear_cache().
+    void clear_cache()
+    {
+        categories.clear_cache();
+        event_names.clear_cache();
+        annotation_names.clear_cache();
+    }
+
+public:
+    /// Append the first packet of the session, which clears the incremental state.
+    void header(std::int64_t process_id);
+
+    /// The events following are recorded by this thread, the thread's track is described once.
+    void thread(std::int64_t process_id, std::int64_t thread_id);
+
+    /// Describe the thread's track with the thread's @a name.
+    void thread_name(std::int64_t process_id, std::int64_t thread_id, std::string_view name);
+
+    /// Append the track event(s) of the @a event.
+    void track_event(event const& event);
+
+private:
+    /// Protobuf's wire types.
+    enum wire_type : std::uint8_t { VARINT = 0, FIXED64 = 1, LENGTH_DELIMITED = 2 };
+
+    void varint(std::uint64_t value)
+    {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7FU) | 0x80U));
+            value >>= 7U;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    void tag(std::uint32_t field, wire_type type) { varint((std::uint64_t{ field } << 3U) | type); }
+
+    void varint_field(std::uint32_t field, std::uint64_t value)
+    {
+        tag(field, VARINT);
+        varint(value);
+    }
+
+    void int_field(std::uint32_t field, std::int64_t value)
+    {
+        varint_field(field, static_cast<std::uint64_t>(value));
+    }
+
+    void double_field(std::uint32_t field, double value);
+
+    void string_field(std::uint32_t field, std::string_view str)
+    {
+        tag(field, LENGTH_DELIMITED);
+        varint(str.size());
+        out.append(str);
+    }
+
+    /// Start the nested message of @a field, the size is patched by end_message() on the
+    /// returned position.
+    std::size_t begin_message(std::uint32_t field);
+
+    void end_message(std::size_t position);
+
+    /// Start the TracePacket message, with time stamp if @a timestamp is non-negative.
+    std::size_t begin_packet(std::int64_t timestamp, std::uint32_t sequence_flags);
+
+    /// Append the interned data of the new strings, if there are some.
+    void interned_data();
+
+    /// Describe the track @a uuid once, the @a describe function appends the descriptor's fields.
+    template <typename DescribeT>
+    void track_descriptor(std::uint64_t uuid, DescribeT&& describe);
+
+    /// Append the TrackEvent packet of @a type on @a track_uuid.
+    void slice_event(event const& event, std::uint64_t track_uuid, std::uint32_t type,
+                     std::int64_t timestamp, bool with_args);
+
+    /// Append the counter packets of the @a event's numerical arguments.
+    void counter_event(event const& event);
+
+    std::uint64_t process_track(std::int64_t process_id);
+
+    std::uint64_t async_track(event const& event);
+
+private:
+    std::string out;
+
+    /// Interned strings, Perfetto's interning IDs start with 1.
+    string_table categories{ 1 };
+    string_table event_names{ 1 };
+    string_table annotation_names{ 1 };
+
+    /// The strings interned by the current event, to be written as interned data.
+    struct new_string {
+        std::uint32_t field;
+        std::uint64_t iid;
+        std::string_view str;
+    };
+    std::vector<new_string> new_strings;
+
+    /// The annotation name IIDs of the current event's arguments.
+    std::vector<std::uint64_t> arg_iids;
+
+    /// The tracks described already.
+    std::unordered_set<std::uint64_t> tracks;
+
+    std::int64_t process_id = 0;
+    std::int64_t thread_id = 0;
+    std::uint64_t thread_track_uuid = 0;
+};
+
+}  // namespace ibis::tool::event_trace::detail
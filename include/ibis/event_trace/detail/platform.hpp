@@ -45,6 +45,9 @@ using id_type = detail::tid_type;
 
 inline id_type id() { return detail::current_thread_id(); }
 
+/// Get the OS name of the calling thread, returns false if there is none.
+inline bool name(char* name, std::size_t size) { return detail::current_thread_name(name, size); }
+
 // Note, the concrete value isn't important since it serves as marker on JSON
 inline constexpr id_type UNKNOWN = 0;
 
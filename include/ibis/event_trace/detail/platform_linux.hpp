@@ -6,9 +6,12 @@
 #pragma once
 
 #include <sys/types.h>
+#include <sys/syscall.h>
 #include <unistd.h>
 #include <pthread.h>
 
+#include <cstddef>
+
 namespace ibis::tool::event_trace::detail {
 
 // ----------------------------------------------------------------------------
@@ -20,10 +23,22 @@ inline pid_type current_proc_id() { return getpid(); }
 // ----------------------------------------------------------------------------
 // Thread info
 // ----------------------------------------------------------------------------
-// FixMe: To gather the thread id the C++ std::thread API doesn't work here since an object is
-// required, see [std::thread](https://en.cppreference.com/w/cpp/thread/thread). Hence
-// Posix Threads API is used on non Windows and hope that we are still portable.
-using tid_type = pthread_t;
-inline tid_type current_thread_id() noexcept { return pthread_self(); }
+// The kernel's thread ID is used, which matches the TID shown by tools like top, perf or gdb
+// and is of 32-bit in contrast to pthread_t. Since the syscall isn't for free, the ID is cached
+// thread locally on first call.
+// FixMe: glibc 2.30 provides gettid(), use it if the minimum requirements allow it.
+using tid_type = pid_t;
+inline tid_type current_thread_id() noexcept
+{
+    static thread_local tid_type const tid = static_cast<tid_type>(syscall(SYS_gettid));
+    return tid;
+}
+
+// Get the name of the calling thread as '\0' terminated string, on Linux restricted to 16 chars
+// including the terminating '\0'.
+inline bool current_thread_name(char* name, std::size_t size) noexcept
+{
+    return pthread_getname_np(pthread_self(), name, size) == 0;
+}
 
 }  // namespace ibis::tool::event_trace::detail
@@ -7,6 +7,7 @@
 
 #include <windows.h>
 #include <cstdint>
+#include <cstddef>
 
 namespace ibis::tool::event_trace::detail {
 
@@ -40,4 +41,11 @@ inline pid_type current_proc_id() { return GetCurrentProcessId(); }
 using tid_type = int32_t;  // DWORD
 inline tid_type current_thread_id() { return GetCurrentThreadId(); }
 
+// FixMe: GetThreadDescription() is available since Windows 10 1607, but returns a wide string.
+inline bool current_thread_name(char* name, [[maybe_unused]] std::size_t size) noexcept
+{
+    name[0] = '\0';
+    return false;
+}
+
 }  // namespace ibis::tool::event_trace::detail
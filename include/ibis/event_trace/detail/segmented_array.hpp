@@ -0,0 +1,184 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace ibis::tool::event_trace::detail {
+
+///
+/// Append only array with stable element addresses, growing without locking.
+///
+/// The elements are stored in segments of doubling size, the segment k holds
+/// FIRST_SEGMENT_SZ << k elements. Segments are allocated on demand and never moved, hence
+/// references to elements are valid during the array's life time. Appending from several threads
+/// concurrently is lock-free: the index is claimed by an atomic counter, the segment is installed
+/// by CAS and the element is published after construction.
+///
+/// @tparam T The element type.
+/// @tparam FIRST_SEGMENT_SZ Size of the first segment, must be a power of 2.
+///
+template <typename T, std::size_t FIRST_SEGMENT_SZ = 64>
+class segmented_array {
+    static_assert(std::has_single_bit(FIRST_SEGMENT_SZ), "segment size must be power of 2");
+
+private:
+    struct slot {
+        std::atomic<bool> ready = false;
+        alignas(T) std::byte storage[sizeof(T)];  // NOLINT(modernize-avoid-c-arrays)
+
+        T& value() { return *std::launder(reinterpret_cast<T*>(&storage)); }
+        T const& value() const { return *std::launder(reinterpret_cast<T const*>(&storage)); }
+    };
+
+    /// Number of segments, limits the capacity to FIRST_SEGMENT_SZ * (2^SEGMENT_COUNT - 1).
+    static constexpr std::size_t SEGMENT_COUNT = 32;
+
+public:
+    segmented_array() = default;
+
+    ~segmented_array()
+    {
+        auto const count = claimed.load(std::memory_order_acquire);
+        for (std::size_t index = 0; index != count; ++index) {
+            auto* const item = find_slot(index);
+            if (item != nullptr && item->ready.load(std::memory_order_relaxed)) {
+                item->value().~T();
+            }
+        }
+        for (auto& segment : segments) {
+            delete[] segment.load(std::memory_order_relaxed);  // NOLINT(cppcoreguidelines-owning-memory)
+        }
+    }
+
+    segmented_array(segmented_array const&) = delete;
+    segmented_array& operator=(segmented_array const&) = delete;
+    segmented_array(segmented_array&&) = delete;
+    segmented_array& operator=(segmented_array&&) = delete;
+
+public:
+    /// Construct a new element at the end and return its index.
+    template <typename... Args>
+    std::size_t emplace_back(Args&&... args)
+    {
+        auto const index = claimed.fetch_add(1, std::memory_order_relaxed);
+        construct(index, std::forward<Args>(args)...);
+        return index;
+    }
+
+    /// Like emplace_back(), but the element's constructor gets its own index as first argument.
+    template <typename... Args>
+    std::size_t emplace_back_indexed(Args&&... args)
+    {
+        auto const index = claimed.fetch_add(1, std::memory_order_relaxed);
+        construct(index, index, std::forward<Args>(args)...);
+        return index;
+    }
+
+    /// Access the element at @a index, which must be published before (e.g. returned by
+    /// emplace_back() and handed over to the calling thread).
+    T& operator[](std::size_t index)
+    {
+        auto* const item = find_slot(index);
+        assert(item != nullptr && item->ready.load(std::memory_order_acquire));
+        return item->value();
+    }
+
+    T const& operator[](std::size_t index) const
+    {
+        auto const* const item = find_slot(index);
+        assert(item != nullptr && item->ready.load(std::memory_order_acquire));
+        return item->value();
+    }
+
+    /// Number of elements claimed, which may not be published yet.
+    std::size_t size() const { return claimed.load(std::memory_order_acquire); }
+
+    /// Call @a func for each published element in index order.
+    template <typename FuncT>
+    void for_each(FuncT&& func) const
+    {
+        auto const count = size();
+        for (std::size_t index = 0; index != count; ++index) {
+            auto const* const item = find_slot(index);
+            if (item != nullptr && item->ready.load(std::memory_order_acquire)) {
+                func(item->value());
+            }
+        }
+    }
+
+    template <typename FuncT>
+    void for_each(FuncT&& func)
+    {
+        auto const count = size();
+        for (std::size_t index = 0; index != count; ++index) {
+            auto* const item = find_slot(index);
+            if (item != nullptr && item->ready.load(std::memory_order_acquire)) {
+                func(item->value());
+            }
+        }
+    }
+
+private:
+    template <typename... Args>
+    void construct(std::size_t index, Args&&... args)
+    {
+        auto const [segment, offset] = locate(index);
+
+        slot& item = install_segment(segment)[offset];
+        ::new (static_cast<void*>(&item.storage)) T(std::forward<Args>(args)...);
+        item.ready.store(true, std::memory_order_release);
+    }
+
+    /// Get segment number and offset of the element at @a index. The segment k starts at index
+    /// FIRST_SEGMENT_SZ * (2^k - 1).
+    static constexpr std::pair<std::size_t, std::size_t> locate(std::size_t index)
+    {
+        auto const segment =
+            static_cast<std::size_t>(std::bit_width(index / FIRST_SEGMENT_SZ + 1)) - 1;
+        auto const offset = index - FIRST_SEGMENT_SZ * ((std::size_t{ 1 } << segment) - 1);
+        return { segment, offset };
+    }
+
+    slot* install_segment(std::size_t segment)
+    {
+        assert(segment < SEGMENT_COUNT && "segmented array exhausted");
+
+        auto* current = segments[segment].load(std::memory_order_acquire);
+        if (current != nullptr) {
+            return current;
+        }
+
+        // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+        auto* fresh = new slot[FIRST_SEGMENT_SZ << segment];
+        if (segments[segment].compare_exchange_strong(current, fresh,  // --
+                                                      std::memory_order_acq_rel)) {
+            return fresh;
+        }
+        delete[] fresh;  // NOLINT(cppcoreguidelines-owning-memory)
+        return current;  // installed concurrently by another thread
+    }
+
+    slot* find_slot(std::size_t index) const
+    {
+        auto const [segment, offset] = locate(index);
+        auto* const base = segments[segment].load(std::memory_order_acquire);
+        return base != nullptr ? base + offset : nullptr;
+    }
+
+private:
+    std::atomic<std::size_t> claimed = 0;
+    std::array<std::atomic<slot*>, SEGMENT_COUNT> segments = {};
+};
+
+}  // namespace ibis::tool::event_trace::detail
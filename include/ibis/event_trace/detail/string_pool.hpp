@@ -0,0 +1,81 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#pragma once
+
+#include <ibis/event_trace/detail/arena.hpp>
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <unordered_set>
+#include <string_view>
+#include <cstdint>
+
+namespace ibis::tool::event_trace::detail {
+
+///
+/// Interning pool for the short strings copied by TraceLog::copy.
+///
+/// Dynamic names usually come from a small set of values, hence each distinct string is copied
+/// only once into the pool and the events refer to this stable, '\0' terminated copy. The pool
+/// is sharded by the string's hash to reduce lock contention, in front of it each thread has a
+/// small lock-free cache of the strings interned recently.
+///
+/// A pool lives for one trace session: TraceLog creates it on BeginLogging() and drops it on
+/// EndLogging(). The event chunks bound during the session share the ownership, so the pool is
+/// released not before the last event referring to it has been flushed.
+///
+class string_pool {
+public:
+    /// Longer strings aren't interned, they are copied for each event.
+    static constexpr std::size_t MAX_STRING_SZ = 128;
+
+    /// The pool stops growing at this size, further strings are copied for each event.
+    static constexpr std::size_t MAX_POOL_SZ = 4 * 1024 * 1024;
+
+    /// Number of shards, must be power of 2.
+    static constexpr std::size_t SHARD_COUNT = 16;
+
+public:
+    string_pool();
+    ~string_pool() = default;
+
+    string_pool(string_pool const&) = delete;
+    string_pool& operator=(string_pool const&) = delete;
+    string_pool(string_pool&&) = delete;
+    string_pool& operator=(string_pool&&) = delete;
+
+public:
+    ///
+    /// Get the pooled copy of @a str.
+    ///
+    /// @return The '\0' terminated copy, or a null string_view if the string can't be interned,
+    /// e.g. it's too long or the pool is full.
+    ///
+    std::string_view intern(std::string_view str);
+
+    /// Number of bytes allocated for the strings.
+    std::size_t size() const { return pool_size.load(std::memory_order_relaxed); }
+
+private:
+    std::string_view intern_locked(std::string_view str, std::size_t hash);
+
+private:
+    struct shard {
+        std::mutex mutex;
+        std::unordered_set<std::string_view> strings;
+        arena storage;
+    };
+
+    /// Unique ID of the pool to validate the thread local cache entries.
+    std::uint64_t const session_id;
+
+    std::atomic<std::size_t> pool_size = 0;
+
+    std::array<shard, SHARD_COUNT> shards;
+};
+
+}  // namespace ibis::tool::event_trace::detail
@@ -0,0 +1,96 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <array>
+#include <utility>
+#include <functional>
+#include <bit>
+#include <cstdint>
+
+namespace ibis::tool::event_trace::detail {
+
+///
+/// Table of the strings written once by the serialization and referred by their ID later, e.g.
+/// the binary format's string table or Perfetto's interned names.
+///
+/// The IDs are cached by the string's address in front of the table, which requires the strings
+/// to stay unchanged until the next clear_cache(). This holds during a flush, the memory of the
+/// flushed event chunks is reused afterwards.
+///
+class string_table {
+public:
+    /// The IDs are assigned in sequence, starting with @a first_id_.
+    explicit string_table(std::uint64_t first_id_ = 0)
+        : first_id{ first_id_ }
+    {
+    }
+
+    ~string_table() = default;
+
+    string_table(string_table const&) = delete;
+    string_table& operator=(string_table const&) = delete;
+    string_table(string_table&&) = delete;
+    string_table& operator=(string_table&&) = delete;
+
+public:
+    /// Get the ID of @a str, the bool is true if the string is new to the table.
+    std::pair<std::uint64_t, bool> insert(std::string_view str)
+    {
+        // Fibonacci hashing of the address, the low bits of arena memory are aligned
+        auto const hash = std::bit_cast<std::uintptr_t>(str.data()) * 0x9E3779B97F4A7C15ULL;
+        auto& entry = cache[static_cast<std::size_t>(hash >> (64U - CACHE_BITS))];
+        if (entry.str == str.data() && entry.str != nullptr) {
+            return { entry.id, false };
+        }
+
+        auto const [iter, inserted] = lookup(str);
+        entry.str = str.data();
+        entry.id = iter->second;
+        return { entry.id, inserted };
+    }
+
+    /// Clear the cache of string addresses, e.g. before the event memory is reused.
+    void clear_cache() { cache.fill(cache_entry{}); }
+
+private:
+    /// Transparent hash to look up the string_view without a temporary string.
+    struct string_hash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view str) const
+        {
+            return std::hash<std::string_view>{}(str);
+        }
+    };
+
+    using map_type = std::unordered_map<std::string, std::uint64_t, string_hash, std::equal_to<>>;
+
+    std::pair<map_type::iterator, bool> lookup(std::string_view str)
+    {
+        if (auto const iter = strings.find(str); iter != strings.end()) {
+            return { iter, false };
+        }
+        return strings.emplace(str, first_id + strings.size());
+    }
+
+private:
+    static constexpr std::size_t CACHE_BITS = 8;
+    static constexpr std::size_t CACHE_SZ = std::size_t{ 1 } << CACHE_BITS;
+
+    struct cache_entry {
+        char const* str = nullptr;
+        std::uint64_t id = 0;
+    };
+
+    std::uint64_t const first_id;
+    map_type strings;
+    std::array<cache_entry, CACHE_SZ> cache = {};
+};
+
+}  // namespace ibis::tool::event_trace::detail
@@ -0,0 +1,131 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#pragma once
+
+#include <ibis/event_trace/detail/platform.hpp>
+#include <ibis/event_trace/detail/segmented_array.hpp>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <string_view>
+
+namespace ibis::tool::event_trace {
+
+///
+/// Registry of the threads which have recorded events.
+///
+/// Each thread registers itself once on its first event, where the thread's OS name is also read.
+/// On registration a thread gets a dense index, which is stored in the TraceEvent records instead
+/// of the (much larger) platform's thread ID. Lookup is lock-free: the calling thread's record is
+/// cached thread locally and the records are kept by a segmented array with stable addresses.
+///
+/// The record of an exited thread is kept until its events are flushed, hence exited threads are
+/// still named in the trace. Afterwards the record is reused by the next thread registering, so
+/// the registry's size is limited by the number of threads alive at once, also for thousands of
+/// short-lived threads. The hand over is done by the owner, see release_current(),
+/// take_exited() and recycle().
+///
+class thread_registry {
+public:
+    /// Dense thread index, used inside the event records.
+    using index_type = std::uint32_t;
+
+    /// Linux limits the thread name to 16 chars including the terminating '\0'. Threads without
+    /// OS name are named 'thread-<id>', where the thread ID is of uint64 in worst case scenario,
+    /// hence log10(2^64) ~ 20 digits. With leading string 'thread-' (7 bytes) and '\0' at least
+    /// 28 bytes are required.
+    static constexpr std::size_t NAME_SZ = 32;
+
+    /// Life cycle of a record.
+    enum class state : std::uint8_t {
+        ACTIVE,  ///< the thread is alive
+        EXITED,  ///< the thread exited, its events may not be flushed yet
+        FREE     ///< to be reused by the next thread registering
+    };
+
+    struct record {
+        /// Registers the calling thread, reads the thread's ID and name.
+        explicit record(std::size_t index_);
+
+        /// Rebind the record to the calling thread, reads the thread's ID and name.
+        void attach();
+
+        current_thread::id_type thread_id = current_thread::UNKNOWN;
+        index_type index = 0;
+        std::array<char, NAME_SZ> name = { '\0' };
+        std::atomic<thread_registry::state> status = state::ACTIVE;
+
+        /// get the thread's name, '\0' terminated.
+        std::string_view thread_name() const { return name.data(); }
+    };
+
+public:
+    thread_registry() = default;
+    ~thread_registry() = default;
+
+    thread_registry(thread_registry const&) = delete;
+    thread_registry& operator=(thread_registry const&) = delete;
+    thread_registry(thread_registry&&) = delete;
+    thread_registry& operator=(thread_registry&&) = delete;
+
+public:
+    /// Get the record of the calling thread, registers the thread on first call.
+    record const& current()
+    {
+        if (current_record == nullptr) {
+            current_record = &acquire();
+        }
+        return *current_record;
+    }
+
+    /// Lookup the thread's record by its dense @a index.
+    record const& operator[](index_type index) const { return records[index]; }
+
+    /// Call @a func for each thread registered and not recycled yet.
+    template <typename FuncT>
+    void for_each(FuncT&& func) const
+    {
+        records.for_each([&func](record const& thread) {
+            if (thread.status.load(std::memory_order_acquire) != state::FREE) {
+                func(thread);
+            }
+        });
+    }
+
+    /// Number of records, including the ones to be reused.
+    std::size_t size() const { return records.size(); }
+
+public:
+    /// Mark the calling thread's record as EXITED, called on thread exit.
+    void release_current();
+
+    /// Get the indices of the threads exited since the last call. These are to be recycled once
+    /// all their events are flushed.
+    std::vector<index_type> take_exited();
+
+    /// Mark the exited threads' records at @a indices as FREE for reuse. There must be no events
+    /// left referring to them and no concurrent for_each().
+    void recycle(std::vector<index_type> const& indices);
+
+private:
+    /// Reuse a FREE record for the calling thread or append a new one.
+    record& acquire();
+
+private:
+    static thread_local record* current_record;
+
+    detail::segmented_array<record> records;
+
+    /// Guards the lists below, taken on registration and thread exit only.
+    std::mutex mutex;
+    std::vector<index_type> exited;
+    std::vector<index_type> free_list;
+};
+
+}  // namespace ibis::tool::event_trace
@@ -5,11 +5,10 @@
 
 #pragma once
 
-#include <variant>
+#include <concepts>
 #include <string_view>
 #include <type_traits>
 #include <cstdint>
-#include <cstring>
 #include <cassert>
 
 namespace ibis::tool::event_trace {
@@ -20,25 +19,46 @@ concept UnsignedIntegerT = !std::is_same_v<bool, T> && std::is_integral_v<T> &&
 template<typename T>
 concept SignedIntegerT = !std::is_same_v<bool, T> && std::is_integral_v<T> && std::is_signed_v<T>;
 
+///
+/// The value of a trace event's argument.
+///
+/// The value is represented by an 8 byte payload and a 1 byte type tag. Inside the event's side
+/// area payload and tag are stored separately (the tags in a small array behind the payloads), so
+/// an argument costs 8 bytes for the payload and 1 byte for the tag only. Formatting switches on
+/// the tag directly, there is no std::variant visiting involved.
+///
+/// MSVC is the reason for overloading the constructor this way, since
+/// @code{.cpp}
+/// trace_value integer(42UL);
+/// @endcode
+/// like [here](https://godbolt.org/z/PoK55MxEe) fails to compile (I'm not sure about why).
+/// Unsigned long differs on platform Unix/Windows (8 vs. 4 Bytes).
+/// @see [Compiler Explorer](https://godbolt.org/z/48xac31rs)
+///
 class trace_value {
 public:
-    /// The variant type of the types supported as arguments.
-    /// The ```std::variant``` is able to hold more than these values
-    /// @see Concept at [Coliru](https://coliru.stacked-crooked.com/a/cf7664e5aab1e340) and
-    /// basic std::variant testing done at
-    /// [Coliru](https://coliru.stacked-crooked.com/a/5838b6bed8339df1)
-    ///
-    /// MSVC is the reason for overloading the constructor this way, since 
-    /// @code{.cpp}
-    /// trace_value integer(42UL);
-    /// @endcode
-    /// like [here](https://godbolt.org/z/PoK55MxEe) fails to compile (I'm not sure about why).
-    /// Unsigned long differs on platform Unix/Windows (8 vs. 4 Bytes).
-    /// @see [Compiler Explorer](https://godbolt.org/z/48xac31rs) 
-    ///
-    using variant_type = std::variant<  // --
-        std::monostate,                 // mark default constructible empty state
-        bool, std::uint64_t, std::int64_t, double, char const *, void const *>;
+    /// The types supported as arguments.
+    enum class type : std::uint8_t {
+        NONE,     ///< empty value, e.g. no argument given
+        BOOL,
+        UINT,     ///< std::uint64_t
+        INT,      ///< std::int64_t
+        DOUBLE,
+        STRING,   ///< '\0' terminated C string
+        POINTER,  ///< void const*
+    };
+
+    /// The payload, interpreted by the type tag.
+    union payload_type {
+        bool boolean;
+        std::uint64_t uint;
+        std::int64_t int_;
+        double real;
+        char const* str;
+        void const* ptr;
+    };
+
+    static_assert(sizeof(payload_type) == 8, "unexpected size of trace_value's payload");
 
 public:
     trace_value() = default;
@@ -48,38 +68,98 @@ public:
     trace_value(trace_value &&) = default;
     trace_value &operator=(trace_value &&) = default;
 
-    trace_value(auto value_)
-        : value{ value_ }
+    ~trace_value() = default;
+
+    /// Reassemble the value from its stored parts.
+    trace_value(type tag_, payload_type payload_)
+        : payload{ payload_ }
+        , tag{ tag_ }
+    {
+    }
+
+    trace_value(bool value_)
+        : tag{ type::BOOL }
     {
+        payload.boolean = value_;
     }
 
     trace_value(UnsignedIntegerT auto value_)
-        : value{ std::uint64_t{value_} }
+        : tag{ type::UINT }
     {
+        payload.uint = std::uint64_t{ value_ };
     }
 
     trace_value(SignedIntegerT auto value_)
-        : value{ std::int64_t{value_} }
+        : tag{ type::INT }
     {
+        payload.int_ = std::int64_t{ value_ };
     }
 
-    trace_value(std::string_view sv)
-        : value{ sv.data() }
+    trace_value(std::floating_point auto value_)
+        : tag{ type::DOUBLE }
     {
+        payload.real = static_cast<double>(value_);
     }
 
-    ~trace_value() = default;
+    trace_value(char const* cstr)
+        : tag{ type::STRING }
+    {
+        payload.str = cstr;
+    }
 
-    bool empty() const
+    trace_value(std::string_view sv)
+        : tag{ type::STRING }
     {
-        // test on std::monostate which marks the empty state
-        return value.index() == 0;
+        payload.str = sv.data();
     }
 
-    variant_type const &data() const { return value; }
+    trace_value(void const* ptr)
+        : tag{ type::POINTER }
+    {
+        payload.ptr = ptr;
+    }
+
+public:
+    bool empty() const { return tag == type::NONE; }
+
+    type type_tag() const { return tag; }
+
+    payload_type data() const { return payload; }
+
+    /// Get the value as type T, which must match the type tag.
+    template <typename T>
+    T get() const
+    {
+        if constexpr (std::is_same_v<T, bool>) {
+            assert(tag == type::BOOL);
+            return payload.boolean;
+        }
+        else if constexpr (std::is_same_v<T, std::uint64_t>) {
+            assert(tag == type::UINT);
+            return payload.uint;
+        }
+        else if constexpr (std::is_same_v<T, std::int64_t>) {
+            assert(tag == type::INT);
+            return payload.int_;
+        }
+        else if constexpr (std::is_same_v<T, double>) {
+            assert(tag == type::DOUBLE);
+            return payload.real;
+        }
+        else if constexpr (std::is_same_v<T, char const*>) {
+            assert(tag == type::STRING);
+            return payload.str;
+        }
+        else {
+            static_assert(std::is_same_v<T, void const*>, "unsupported type");
+            assert(tag == type::POINTER);
+            return payload.ptr;
+        }
+    }
 
 private:
-    variant_type value;
+    payload_type payload = { .uint = 0 };
+    type tag = type::NONE;
 };
 
 }  // namespace ibis::tool::event_trace
@@ -0,0 +1,76 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <cstdint>
+
+namespace ibis::tool::event_trace::detail {
+
+///
+/// Fixed size pool of worker threads to run the iterations of a loop in parallel.
+///
+/// Intended for TraceLog::Flush(), which serializes the event batches in parallel: run() hands
+/// out the indices of the loop one by one to the workers and to the calling thread, and returns
+/// after all of them are done. The order of execution is unspecified, hence the task has to
+/// write its results into per index storage.
+///
+class worker_pool {
+public:
+    using task_type = std::function<void(std::size_t)>;
+
+public:
+    /// Pool of @a thread_count threads, including the thread calling run().
+    explicit worker_pool(std::size_t thread_count);
+    ~worker_pool();
+
+    worker_pool(worker_pool const&) = delete;
+    worker_pool& operator=(worker_pool const&) = delete;
+    worker_pool(worker_pool&&) = delete;
+    worker_pool& operator=(worker_pool&&) = delete;
+
+public:
+    /// Number of threads running the tasks, including the thread calling run().
+    std::size_t size() const { return workers.size() + 1; }
+
+    ///
+    /// Run the @a task for each index of [0, @a count) and wait for completion.
+    ///
+    /// The first exception thrown by a task is rethrown, the remaining indices are still run.
+    /// Only one run() may be active at once.
+    ///
+    void run(std::size_t count, task_type const& task);
+
+private:
+    void worker_loop();
+
+    /// Run the task for the indices not claimed yet.
+    void execute(task_type const& task, std::size_t count);
+
+private:
+    std::vector<std::thread> workers;
+
+    /// Guards the job's state below.
+    std::mutex mutex;
+    std::condition_variable start_cv;
+    std::condition_variable done_cv;
+    task_type const* job_task = nullptr;
+    std::size_t job_count = 0;
+    std::uint64_t job_id = 0;
+    std::size_t busy = 0;  // workers running the current job
+    std::exception_ptr error;
+    bool stop = false;
+
+    std::atomic<std::size_t> next_index = 0;
+};
+
+}  // namespace ibis::tool::event_trace::detail
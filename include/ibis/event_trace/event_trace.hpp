@@ -12,8 +12,12 @@
 #include <ibis/event_trace/category.hpp>
 #include <ibis/event_trace/scoped_event.hpp>
 #include <ibis/event_trace/trace_id.hpp>
+#include <ibis/event_trace/trace_site.hpp>
+#include <ibis/event_trace/detail/category_list.hpp>
 
 #include <string_view>
+#include <type_traits>
+#include <cstdint>
 #include <variant>
 #include <optional>
 #include <iostream>
@@ -48,6 +52,31 @@ namespace ibis::tool::event_trace {
 // off macros
 // ****************************************************************************
 
+// ----------------------------------------------------------------------------
+// configuration
+// ----------------------------------------------------------------------------
+
+/// Scoped events are recorded as single complete event ('X') with duration at the end of scope.
+/// Defined to 0, a begin event ('B') is recorded at the begin and an end event ('E') at the end of
+/// scope, which allows viewing scopes not completed at the time of flushing.
+#if !defined(IBIS_TRACE_EVENT_COMPLETE_SCOPES)
+#define IBIS_TRACE_EVENT_COMPLETE_SCOPES 1
+#endif
+
+/// Comma separated list of categories compiled out, e.g. for release builds:
+/// @code
+/// -DIBIS_TRACE_DISABLED_CATEGORIES='"debug, gui.*"'
+/// @endcode
+/// An entry with trailing '*' is a prefix matching all categories starting with, see
+/// detail::category_listed(). The trace macros of these categories expand to nothing at all,
+/// neither the category is registered nor the arguments are evaluated.
+#if defined(IBIS_TRACE_DISABLED_CATEGORIES)
+#define INTERNAL_TRACE_EVENT_CATEGORY_COMPILED_IN(cat_name) \
+    (!detail::category_listed(IBIS_TRACE_DISABLED_CATEGORIES, cat_name))
+#else
+#define INTERNAL_TRACE_EVENT_CATEGORY_COMPILED_IN(cat_name) true
+#endif
+
 // ----------------------------------------------------------------------------
 // unique name macro
 // ----------------------------------------------------------------------------
@@ -67,21 +96,25 @@ namespace ibis::tool::event_trace {
 // ----------------------------------------------------------------------------
 
 ///////////////////////////////////////////////////////////////////////////////
-/// Records a pair of begin and end events called "event_name" for the current scope, with 0, 1 or 2
+/// Records a complete event (or a pair of begin and end events, see
+/// IBIS_TRACE_EVENT_COMPLETE_SCOPES) called "event_name" for the current scope, with 0, 1 or 2
 /// associated arguments. If the category is not enabled, then this does nothing.
 ///
-/// Note: ```category_name``` strings must have application lifetime (statics or literals).
+/// Note: ```category_name``` strings must be constant expressions (literals or constexpr statics).
 ///
 #define TRACE_EVENT0(category_name, event_name) \
     INTERNAL_TRACE_EVENT_ADD_SCOPED(category_name, event_name)
-#define TRACE_EVENT1(category_name, event_name1_name, arg1_val) \
+#define TRACE_EVENT1(category_name, event_name, arg1_name, arg1_val) \
     INTERNAL_TRACE_EVENT_ADD_SCOPED(category_name, event_name, arg1_name, arg1_val)
+#define TRACE_EVENT2(category_name, event_name, arg1_name, arg1_val, arg2_name, arg2_val) \
+    INTERNAL_TRACE_EVENT_ADD_SCOPED(category_name, event_name, arg1_name, arg1_val,       \
+                                    arg2_name, arg2_val)
 
 ///////////////////////////////////////////////////////////////////////////////
 /// Records a single BEGIN event called "event_name" immediately, with 0, 1 or 2  associated
 /// arguments. If the category is not enabled, then this does nothing.
 ///
-/// Note: ```category_name``` strings must have application lifetime (statics or literals).
+/// Note: ```category_name``` strings must be constant expressions (literals or constexpr statics).
 ///
 #define TRACE_EVENT_BEGIN0(category_name, event_name)                             \
     INTERNAL_TRACE_EVENT_ADD(TraceEvent::phase::BEGIN, category_name, event_name, \
@@ -91,28 +124,37 @@ namespace ibis::tool::event_trace {
     INTERNAL_TRACE_EVENT_ADD(TraceEvent::phase::BEGIN, category_name, event_name, \
                              TraceEvent::flag::NONE, arg1_name, arg1_val)
 
+#define TRACE_EVENT_BEGIN2(category_name, event_name, arg1_name, arg1_val, arg2_name, arg2_val) \
+    INTERNAL_TRACE_EVENT_ADD(TraceEvent::phase::BEGIN, category_name, event_name,               \
+                             TraceEvent::flag::NONE, arg1_name, arg1_val, arg2_name, arg2_val)
+
 ///////////////////////////////////////////////////////////////////////////////
-/// Records a single END event for "event_name" immediately. If the category is not enabled, then
-/// this does nothing.
+/// Records a single END event for "event_name" immediately, with 0, 1 or 2 associated
+/// arguments. If the category is not enabled, then this does nothing.
 ///
-/// Note: ```category_name``` strings must have application lifetime (statics or literals).
+/// Note: ```category_name``` strings must be constant expressions (literals or constexpr statics).
 ///
 #define TRACE_EVENT_END0(category_name, event_name)                             \
     INTERNAL_TRACE_EVENT_ADD(TraceEvent::phase::END, category_name, event_name, \
-                             TraceEvent::flag::NONE, arg1_name, arg1_val)
+                             TraceEvent::flag::NONE)
 
-#define TRACE_EVENT_END1(category_name, event_name)                             \
+#define TRACE_EVENT_END1(category_name, event_name, arg1_name, arg1_val)        \
     INTERNAL_TRACE_EVENT_ADD(TraceEvent::phase::END, category_name, event_name, \
                              TraceEvent::flag::NONE, arg1_name, arg1_val)
 
+#define TRACE_EVENT_END2(category_name, event_name, arg1_name, arg1_val, arg2_name, arg2_val) \
+    INTERNAL_TRACE_EVENT_ADD(TraceEvent::phase::END, category_name, event_name,               \
+                             TraceEvent::flag::NONE, arg1_name, arg1_val, arg2_name, arg2_val)
+
 ///////////////////////////////////////////////////////////////////////////////
 /// Time threshold event:  Only record the event if the duration is greater than the specified
 /// threshold_us (time in microseconds). If the category is not enabled, then this does nothing.
 ///
-/// Records a pair of begin and end events called "event_name" for the current scope, with 0, 1 or 2
-/// associated arguments.
+/// Records a complete event called "event_name" for the current scope, with 0, 1 or 2 associated
+/// arguments.
 ///
-/// Note: ```category_name``` strings must have application lifetime (statics or literals).
+/// Note: ```category_name``` strings must be constant expressions (literals or constexpr statics). The
+/// arguments are evaluated at the begin of scope, but recorded at the end of scope.
 ///
 #define TRACE_EVENT_IF_LONGER_THAN0(threshold_us, category_name, event_name) \
     INTERNAL_TRACE_EVENT_ADD_SCOPED_IF_LONGER_THAN(threshold_us, category_name, event_name)
@@ -121,12 +163,17 @@ namespace ibis::tool::event_trace {
     INTERNAL_TRACE_EVENT_ADD_SCOPED_IF_LONGER_THAN(threshold_us, category_name, event_name,       \
                                                    arg1_name, arg1_val)
 
+#define TRACE_EVENT_IF_LONGER_THAN2(threshold_us, category_name, event_name, arg1_name, arg1_val, \
+                                    arg2_name, arg2_val)                                          \
+    INTERNAL_TRACE_EVENT_ADD_SCOPED_IF_LONGER_THAN(threshold_us, category_name, event_name,       \
+                                                   arg1_name, arg1_val, arg2_name, arg2_val)
+
 ///////////////////////////////////////////////////////////////////////////////
 /// Records a single event called "event_name" immediately, with 0, 1 or 2
 /// associated arguments. If the category is not enabled, then this
 /// does nothing.
 ///
-/// Note: ```category_name``` strings must have application lifetime (statics or literals).
+/// Note: ```category_name``` strings must be constant expressions (literals or constexpr statics).
 ///
 #define TRACE_EVENT_INSTANT0(category_name, event_name)                             \
     INTERNAL_TRACE_EVENT_ADD(TraceEvent::phase::INSTANT, category_name, event_name, \
@@ -136,17 +183,31 @@ namespace ibis::tool::event_trace {
     INTERNAL_TRACE_EVENT_ADD(TraceEvent::phase::INSTANT, category_name, event_name, \
                              TraceEvent::flag::NONE, arg1_name, arg1_val)
 
+#define TRACE_EVENT_INSTANT2(category_name, event_name, arg1_name, arg1_val, arg2_name, arg2_val) \
+    INTERNAL_TRACE_EVENT_ADD(TraceEvent::phase::INSTANT, category_name, event_name,               \
+                             TraceEvent::flag::NONE, arg1_name, arg1_val, arg2_name, arg2_val)
+
 ///////////////////////////////////////////////////////////////////////////////
 /// Records the value of a counter called "event_name" immediately. Value
 /// must be representable as a 64 bit integer.
 ///
-/// Note: ```category_name``` strings must have application lifetime (statics or literals).
+/// Note: ```category_name``` strings must be constant expressions (literals or constexpr statics).
 ///
 #define TRACE_COUNTER1(category_name, event_name, value)                            \
     INTERNAL_TRACE_EVENT_ADD(TraceEvent::phase::COUNTER, category_name, event_name, \
                              TraceEvent::flag::NONE, "value", static_cast<std::int64_t>(value))
 
-// ToDo: add the "Arg2" version
+///////////////////////////////////////////////////////////////////////////////
+/// Records the values of a multi-valued counter called "event_name" immediately. The values
+/// must be representable as a 64 bit integer.
+///
+/// Note: ```category_name``` strings must be constant expressions (literals or constexpr statics).
+///
+#define TRACE_COUNTER2(category_name, event_name, value1_name, value1_val, value2_name, value2_val) \
+    INTERNAL_TRACE_EVENT_ADD(TraceEvent::phase::COUNTER, category_name, event_name,                 \
+                             TraceEvent::flag::NONE,                                                \
+                             value1_name, static_cast<std::int64_t>(value1_val),                    \
+                             value2_name, static_cast<std::int64_t>(value2_val))
 
 ///////////////////////////////////////////////////////////////////////////////
 /// Records the value of a counter called "event_name" immediately. Value
@@ -156,14 +217,25 @@ namespace ibis::tool::event_trace {
 /// integer value up to 64 bits. If it's a pointer, the bits will be XOR-ed with a hash of the
 /// process ID so that the same pointer on two different processes will not collide.
 ///
-/// Note: ```category_name``` strings must have application lifetime (statics or literals).
+/// Note: ```category_name``` strings must be constant expressions (literals or constexpr statics).
 ///
 #define TRACE_COUNTER_ID1(category_name, event_name, id, value)                                 \
     INTERNAL_TRACE_EVENT_ADD_WITH_ID(TraceEvent::phase::COUNTER, category_name, event_name, id, \
                                      TraceEvent::flag::NONE, "value",                           \
                                      static_cast<std::int64_t>(value))
 
-// ToDo: add the "Arg2" version
+///////////////////////////////////////////////////////////////////////////////
+/// Records the values of a multi-valued counter called "event_name" immediately, @a id see
+/// TRACE_COUNTER_ID1.
+///
+/// Note: ```category_name``` strings must be constant expressions (literals or constexpr statics).
+///
+#define TRACE_COUNTER_ID2(category_name, event_name, id, value1_name, value1_val, value2_name,   \
+                          value2_val)                                                           \
+    INTERNAL_TRACE_EVENT_ADD_WITH_ID(TraceEvent::phase::COUNTER, category_name, event_name, id, \
+                                     TraceEvent::flag::NONE,                                    \
+                                     value1_name, static_cast<std::int64_t>(value1_val),        \
+                                     value2_name, static_cast<std::int64_t>(value2_val))
 
 ///////////////////////////////////////////////////////////////////////////////
 /// Records a single ASYNC_BEGIN event called "event_name" immediately, with 0, 1 or 2 associated
@@ -179,7 +251,7 @@ namespace ibis::tool::event_trace {
 /// pointer or an integer value up to 64 bits. If it's a pointer, the bits will be XOR-ed with a
 /// hash of the process ID so that the same pointer on two different processes will not collide.
 ///
-/// Note: ```category_name``` strings must have application lifetime (statics or literals).
+/// Note: ```category_name``` strings must be constant expressions (literals or constexpr statics).
 ///
 #define TRACE_EVENT_ASYNC_BEGIN0(category_name, event_name, id)                                 \
     INTERNAL_TRACE_EVENT_ADD_WITH_ID(TraceEvent::phase::ASYNC_BEGIN, category_name, event_name, \
@@ -189,6 +261,12 @@ namespace ibis::tool::event_trace {
     INTERNAL_TRACE_EVENT_ADD_WITH_ID(TraceEvent::phase::ASYNC_BEGIN, category_name, event_name, \
                                      id, TraceEvent::flag::NONE, arg1_name, arg1_val)
 
+#define TRACE_EVENT_ASYNC_BEGIN2(category_name, event_name, id, arg1_name, arg1_val, arg2_name, \
+                                 arg2_val)                                                      \
+    INTERNAL_TRACE_EVENT_ADD_WITH_ID(TraceEvent::phase::ASYNC_BEGIN, category_name, event_name, \
+                                     id, TraceEvent::flag::NONE, arg1_name, arg1_val,           \
+                                     arg2_name, arg2_val)
+
 ///////////////////////////////////////////////////////////////////////////////
 /// Records a single ASYNC_STEP event for @a step immediately. If the category is not enabled, then
 /// this does nothing.
@@ -197,13 +275,15 @@ namespace ibis::tool::event_trace {
 /// this step within the async event. This should be called at the beginning of the next phase of an
 /// asynchronous operation.
 ///
-/// Note: ```category_name``` strings must have application lifetime (statics or literals).
+/// Note: ```category_name``` strings must be constant expressions (literals or constexpr statics).
 ///
 #define TRACE_EVENT_ASYNC_BEGIN_STEP0(category_name, event_name, id, step)                         \
     INTERNAL_TRACE_EVENT_ADD_WITH_ID(TraceEvent::phase::ASYNC_STEP, category_name, event_name, id, \
                                      TraceEvent::flag::NONE, "step", step)
 
-// ToDo: add the "Arg2" version
+#define TRACE_EVENT_ASYNC_BEGIN_STEP1(category_name, event_name, id, step, arg1_name, arg1_val)   \
+    INTERNAL_TRACE_EVENT_ADD_WITH_ID(TraceEvent::phase::ASYNC_STEP, category_name, event_name, id, \
+                                     TraceEvent::flag::NONE, "step", step, arg1_name, arg1_val)
 
 ///////////////////////////////////////////////////////////////////////////////
 /// Records a single ASYNC_END event for "event_name" immediately. If the category is not enabled,
@@ -216,7 +296,11 @@ namespace ibis::tool::event_trace {
     INTERNAL_TRACE_EVENT_ADD_WITH_ID(TraceEvent::phase::ASYNC_END, category_name, event_name, id, \
                                      TraceEvent::flag::NONE, arg1_name, arg1_val)
 
-// ToDo: add the Arg2 version
+#define TRACE_EVENT_ASYNC_END2(category_name, event_name, id, arg1_name, arg1_val, arg2_name,     \
+                               arg2_val)                                                         \
+    INTERNAL_TRACE_EVENT_ADD_WITH_ID(TraceEvent::phase::ASYNC_END, category_name, event_name, id, \
+                                     TraceEvent::flag::NONE, arg1_name, arg1_val,                 \
+                                     arg2_name, arg2_val)
 
 // ----------------------------------------------------------------------------
 // Implementation details of trace event macros
@@ -228,42 +312,95 @@ namespace ibis::tool::event_trace {
 /// Macro to create static category proxy
 // FixMe: rename to: TRACE_EVENT_PRIVATE_GET_CATEGORY_PROXY
 ///
-#define INTERNAL_TRACE_EVENT_GET_CATEGORY_INFO(category_name) \
-    static auto const EVENT_TRACE_PRIVATE_UNIQUE_NAME(category) = category::get(category_name)
+#define INTERNAL_TRACE_EVENT_GET_CATEGORY_INFO(category_name)    \
+    static auto const EVENT_TRACE_PRIVATE_UNIQUE_NAME(category) = \
+        INTERNAL_TRACE_EVENT_GET_CATEGORY(category_name)
+
+///
+/// Macro to get the category proxy, the hash of the category name is computed at compile time.
+/// Hence the category names given to the macros must be constant expressions, e.g. literals.
+///
+#define INTERNAL_TRACE_EVENT_GET_CATEGORY(cat_name) \
+    category::get(cat_name, std::integral_constant<std::uint64_t, detail::fnv1a(cat_name)>::value)
 
 // ------------------------------------------------------------------------------------------------
 
 ///
 /// Macro to create static category and add the begin event if the category is enabled. Also adds
-/// the end event when the scope ends.
+/// the end event when the scope ends. With IBIS_TRACE_EVENT_COMPLETE_SCOPES a single complete event
+/// is added at the end of scope instead.
 ///
+#if IBIS_TRACE_EVENT_COMPLETE_SCOPES
 #define INTERNAL_TRACE_EVENT_ADD_SCOPED(cat_name, event_name, ...)                                 \
-    static auto const EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy) = category::get(cat_name);   \
-    scope_guard EVENT_TRACE_PRIVATE_UNIQUE_NAME(scope_guard)(                                      \
-        EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy), event_name);                              \
-    if (EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy)) {                                         \
-        AddTraceEvent(TraceEvent::phase::BEGIN,                                                    \
-                      EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy).category_name(), event_name, \
-                      TraceID::NONE, TraceEvent::flag::NONE, ##__VA_ARGS__);                       \
-    }
+    INTERNAL_TRACE_EVENT_DECLARE_SCOPE_GUARD(cat_name, scope_complete_guard, event_name,           \
+                                             ##__VA_ARGS__)
+#else
+#define INTERNAL_TRACE_EVENT_ADD_SCOPED(cat_name, event_name, ...)                                 \
+    [[maybe_unused]] auto const EVENT_TRACE_PRIVATE_UNIQUE_NAME(scope_guard) = [&]() {             \
+        if constexpr (INTERNAL_TRACE_EVENT_CATEGORY_COMPILED_IN(cat_name)) {                       \
+            static auto const EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy) =                    \
+                INTERNAL_TRACE_EVENT_GET_CATEGORY(cat_name);                                       \
+            auto const& EVENT_TRACE_PRIVATE_UNIQUE_NAME(name) = event_name;                        \
+            if (EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy)) {                                 \
+                static trace_site const EVENT_TRACE_PRIVATE_UNIQUE_NAME(begin_site)(               \
+                    EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy), TraceEvent::phase::BEGIN,     \
+                    EVENT_TRACE_PRIVATE_UNIQUE_NAME(name));                                        \
+                AddTraceEvent(EVENT_TRACE_PRIVATE_UNIQUE_NAME(begin_site),                         \
+                              EVENT_TRACE_PRIVATE_UNIQUE_NAME(name), TraceID::NONE,                \
+                              TraceEvent::flag::NONE, ##__VA_ARGS__);                              \
+            }                                                                                      \
+            static trace_site const EVENT_TRACE_PRIVATE_UNIQUE_NAME(end_site)(                     \
+                EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy), TraceEvent::phase::END,           \
+                EVENT_TRACE_PRIVATE_UNIQUE_NAME(name));                                            \
+            return scope_guard(EVENT_TRACE_PRIVATE_UNIQUE_NAME(end_site),                          \
+                               EVENT_TRACE_PRIVATE_UNIQUE_NAME(name));                             \
+        }                                                                                          \
+        else {                                                                                     \
+            return null_scope_guard{};                                                             \
+        }                                                                                          \
+    }()
+#endif
 
 // ------------------------------------------------------------------------------------------------
 
-/// Macro to create static category and add begin  event if the category is enabled. Also adds the
-/// end event when the scope  ends. If the elapsed time is < threshold time, the begin/end pair is
-/// erased.
-#define INTERNAL_TRACE_EVENT_ADD_SCOPED_IF_LONGER_THAN(threshold, cat_name, event_name, ...)     \
-    static auto const EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy) = category::get(cat_name); \
-    scope_threshold_guard EVENT_TRACE_PRIVATE_UNIQUE_NAME(scope_guard)(                          \
-        EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy), event_name, threshold);                 \
-    if (EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy)) {                                       \
-        auto const EVENT_TRACE_PRIVATE_UNIQUE_NAME(begin_event_id) =                             \
-            AddTraceEvent(TraceEvent::phase::BEGIN,                                              \
-                          EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy).category_name(),       \
-                          event_name, TraceID::NONE, TraceEvent::flag::NONE, ##__VA_ARGS__);     \
-        EVENT_TRACE_PRIVATE_UNIQUE_NAME(scope_guard)                                             \
-            .set_threshold_begin_id(EVENT_TRACE_PRIVATE_UNIQUE_NAME(begin_event_id));            \
-    }
+/// Macro to create static category and a guard, which adds a complete event when the scope ends,
+/// but only if the elapsed time is >= threshold time (in microseconds). Nothing is recorded at the
+/// begin of scope.
+#define INTERNAL_TRACE_EVENT_ADD_SCOPED_IF_LONGER_THAN(threshold_us, cat_name, event_name, ...)  \
+    INTERNAL_TRACE_EVENT_DECLARE_SCOPE_GUARD(cat_name, scope_threshold_guard, event_name,        \
+                                             std::chrono::microseconds(threshold_us),            \
+                                             ##__VA_ARGS__)
+
+// ------------------------------------------------------------------------------------------------
+
+///
+/// Macro to declare the scope guard of type @a guard_type for the static call site of complete
+/// events, the @a event_name and remaining arguments are passed to the guard's constructor. The
+/// site is only built for categories enabled, otherwise the guard is constructed from the
+/// category's proxy. For categories compiled out, a null_scope_guard is declared instead. The
+/// lambda is required to declare the scope guard's variable of different type in the enclosing
+/// scope; the guard is constructed in place (guaranteed copy elision).
+///
+#define INTERNAL_TRACE_EVENT_DECLARE_SCOPE_GUARD(cat_name, guard_type, event_name, ...)             \
+    [[maybe_unused]] auto const EVENT_TRACE_PRIVATE_UNIQUE_NAME(scope_guard) = [&]() {              \
+        if constexpr (INTERNAL_TRACE_EVENT_CATEGORY_COMPILED_IN(cat_name)) {                        \
+            static auto const EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy) =                     \
+                INTERNAL_TRACE_EVENT_GET_CATEGORY(cat_name);                                        \
+            auto const& EVENT_TRACE_PRIVATE_UNIQUE_NAME(name) = event_name;                         \
+            if (EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy)) {                                  \
+                static trace_site const EVENT_TRACE_PRIVATE_UNIQUE_NAME(site)(                      \
+                    EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy), TraceEvent::phase::COMPLETE,   \
+                    EVENT_TRACE_PRIVATE_UNIQUE_NAME(name));                                         \
+                return guard_type(EVENT_TRACE_PRIVATE_UNIQUE_NAME(site),                            \
+                                  EVENT_TRACE_PRIVATE_UNIQUE_NAME(name), ##__VA_ARGS__);            \
+            }                                                                                       \
+            return guard_type(EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy),                      \
+                              EVENT_TRACE_PRIVATE_UNIQUE_NAME(name), ##__VA_ARGS__);                \
+        }                                                                                           \
+        else {                                                                                      \
+            return null_scope_guard{};                                                              \
+        }                                                                                           \
+    }()
 
 // ------------------------------------------------------------------------------------------------
 
@@ -272,11 +409,18 @@ namespace ibis::tool::event_trace {
 ///
 #define INTERNAL_TRACE_EVENT_ADD(phase, cat_name, event_name, flags, ...)                         \
     do {                                                                                          \
-        static auto const EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy) =                       \
-            category::get(cat_name);                                                              \
-        if (EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy)) {                                    \
-            AddTraceEvent(phase, EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy).category_name(), \
-                          event_name, TraceID::NONE, flags, ##__VA_ARGS__);                       \
+        if constexpr (INTERNAL_TRACE_EVENT_CATEGORY_COMPILED_IN(cat_name)) {                      \
+            static auto const EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy) =                   \
+                INTERNAL_TRACE_EVENT_GET_CATEGORY(cat_name);                                      \
+            if (EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy)) {                                \
+                auto const& EVENT_TRACE_PRIVATE_UNIQUE_NAME(name) = event_name;                   \
+                static trace_site const EVENT_TRACE_PRIVATE_UNIQUE_NAME(site)(                    \
+                    EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy), phase,                       \
+                    EVENT_TRACE_PRIVATE_UNIQUE_NAME(name));                                       \
+                AddTraceEvent(EVENT_TRACE_PRIVATE_UNIQUE_NAME(site),                              \
+                              EVENT_TRACE_PRIVATE_UNIQUE_NAME(name), TraceID::NONE, flags,        \
+                              ##__VA_ARGS__);                                                     \
+            }                                                                                     \
         }                                                                                         \
     } while (0)
 // ------------------------------------------------------------------------------------------------
@@ -286,14 +430,20 @@ namespace ibis::tool::event_trace {
 ///
 #define INTERNAL_TRACE_EVENT_ADD_WITH_ID(phase, cat_name, event_name, id, flags, ...)             \
     do {                                                                                          \
-        static auto const EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy) =                       \
-            category::get(cat_name);                                                              \
-        if (EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy)) {                                    \
-            TraceEvent::flag trace_event_flags = flags | TraceEvent::flag::HAS_ID;                \
-            TraceID trace_event_trace_id(id, trace_event_flags);                                  \
-            AddTraceEvent(phase, EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy).category_name(), \
-                          event_name, trace_event_trace_id.value(), trace_event_flags,            \
-                          ##__VA_ARGS__);                                                         \
+        if constexpr (INTERNAL_TRACE_EVENT_CATEGORY_COMPILED_IN(cat_name)) {                      \
+            static auto const EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy) =                   \
+                INTERNAL_TRACE_EVENT_GET_CATEGORY(cat_name);                                      \
+            if (EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy)) {                                \
+                TraceEvent::flag trace_event_flags = flags | TraceEvent::flag::HAS_ID;            \
+                TraceID trace_event_trace_id(id, trace_event_flags);                              \
+                auto const& EVENT_TRACE_PRIVATE_UNIQUE_NAME(name) = event_name;                   \
+                static trace_site const EVENT_TRACE_PRIVATE_UNIQUE_NAME(site)(                    \
+                    EVENT_TRACE_PRIVATE_UNIQUE_NAME(category_proxy), phase,                       \
+                    EVENT_TRACE_PRIVATE_UNIQUE_NAME(name));                                       \
+                AddTraceEvent(EVENT_TRACE_PRIVATE_UNIQUE_NAME(site),                              \
+                              EVENT_TRACE_PRIVATE_UNIQUE_NAME(name), trace_event_trace_id.value(), \
+                              trace_event_flags, ##__VA_ARGS__);                                  \
+            }                                                                                     \
         }                                                                                         \
     } while (0)
 
@@ -322,33 +472,58 @@ inline std::int32_t AddTraceEvent(                     // --
     return TraceLog::GetInstance().AddTraceEvent(  // --
         phase, category_name, event_name,          // --
         trace_id, flags,                           // --
-        TraceLog::EVENT_ID_NONE, clock::duration_zero);
+        clock::time<>::ticks(), 0);
 }
 
 ///
-/// @brief One argument version.
+/// @brief Arguments version, up to IBIS_TRACE_EVENT_MAX_ARGS pairs of key and value.
 ///
 /// @param phase TraceEvent's phase to indicate the nature of an event entry.
 /// @param category_name Category name.
 /// @param event_name Event name.
 /// @param trace_id TraceEvent's TraceID.
 /// @param flags TraceEvent's flags.
-/// @param arg1_name Name for the optional argument.
-/// @param arg1_value Value for the optional argument.
+/// @param args The arguments as sequence of key name and value.
 /// @return The ID of the stored event.
 ///
-template <typename NameT, typename Arg1_KeyT, typename Arg1_ValueT>
+template <typename NameT, typename... ArgsT>
+requires (sizeof...(ArgsT) != 0) && CountArgT<ArgsT...>
 inline std::int32_t AddTraceEvent(                     // --
     TraceEvent::phase phase,                           // --
     std::string_view category_name, NameT event_name,  // --
     std::uint64_t trace_id, TraceEvent::flag flags,    // --
-    Arg1_KeyT arg1_name, Arg1_ValueT arg1_value)
+    ArgsT... args)
 {
     return TraceLog::GetInstance().AddTraceEvent(        // --
         phase, category_name, event_name,                // --
         trace_id, flags,                                 // --
-        TraceLog::EVENT_ID_NONE, clock::duration_zero,   // Threshold support
-        arg1_name, arg1_value                            // arg { key : value }
+        clock::time<>::ticks(), 0,                       // time point, no duration
+        args...                                          // args { key : value }
+    );
+}
+
+///
+/// @brief Call site version, the phase and category name are given by the @a site.
+///
+/// @param site The call site's static data.
+/// @param event_name Event name.
+/// @param trace_id TraceEvent's TraceID.
+/// @param flags TraceEvent's flags.
+/// @param args The optional arguments as sequence of key name and value.
+/// @return The ID of the stored event.
+///
+template <typename NameT, typename... ArgsT>
+requires CountArgT<ArgsT...>
+inline std::int32_t AddTraceEvent(                     // --
+    trace_site const& site, NameT event_name,          // --
+    std::uint64_t trace_id, TraceEvent::flag flags,    // --
+    ArgsT... args)
+{
+    return TraceLog::GetInstance().AddTraceEvent(        // --
+        site, event_name,                                // --
+        trace_id, flags,                                 // --
+        clock::time<>::ticks(), 0,                       // time point, no duration
+        args...                                          // args { key : value }
     );
 }
 
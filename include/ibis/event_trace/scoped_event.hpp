@@ -7,18 +7,87 @@
 
 #include <ibis/event_trace/category.hpp>
 #include <ibis/event_trace/trace_log.hpp>
+#include <ibis/event_trace/trace_site.hpp>
 #include <ibis/event_trace/trace_id.hpp>
 
+#include <string>
 #include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <iostream>
 
 namespace ibis::tool::event_trace {
 
+namespace detail {
+
+///
+/// Owning storage of a `TraceLog::copy` argument of the scope guards, which record their event at
+/// the end of scope. The marker doesn't own the string, which may be a temporary gone by then,
+/// hence the string is copied on construction of the guard - only if the category is enabled.
+///
+class scope_copy {
+public:
+    scope_copy(bool enabled, TraceLog::copy const& str)
+        : value{ enabled ? str.get_sv() : std::string_view{} }
+    {
+    }
+
+    /// The copy marker of the owned string to be recorded.
+    TraceLog::copy get() const { return TraceLog::copy{ value }; }
+
+private:
+    std::string value;
+};
+
+/// The type of the scope guard's argument stored for argument type T.
+template <typename T>
+struct scope_arg {
+    using type = T;
+};
+
+template <>
+struct scope_arg<TraceLog::copy> {
+    using type = scope_copy;
+};
+
+template <typename T>
+using scope_arg_t = typename scope_arg<std::decay_t<T>>::type;
+
+/// Capture the argument @a arg at the begin of scope, the `TraceLog::copy` marked strings are
+/// copied if @a enabled.
+template <typename T>
+decltype(auto) capture_scope_arg([[maybe_unused]] bool enabled, T&& arg)
+{
+    if constexpr (std::is_same_v<std::decay_t<T>, TraceLog::copy>) {
+        return scope_copy{ enabled, arg };
+    }
+    else {
+        return std::forward<T>(arg);
+    }
+}
+
+/// Get the argument @a arg captured by @ref capture_scope_arg to be recorded.
+template <typename T>
+decltype(auto) recorded_scope_arg(T const& arg)
+{
+    if constexpr (std::is_same_v<T, scope_copy>) {
+        return arg.get();
+    }
+    else {
+        return (arg);
+    }
+}
+
+}  // namespace detail
+
 ///
 /// Scope guard base.
 ///
-/// Using CRTP to implement concrete scope guard implementation. On destruction it adds an
-/// trace event to trace log.
-/// On class' destruction the duration event 'end' is emitted.
+/// Using CRTP to implement concrete scope guard implementation. The base keeps the time point of
+/// the scope's begin, if the category is enabled. On destruction of the concrete scope guard, the
+/// derived class' add_event() is called to add the trace event to trace log, e.g. the duration
+/// event 'end' or a complete event with the scope's duration. Guards constructed with a
+/// @ref trace_site record the events at this site, which must match the recorded phase.
 ///
 /// Concept see [godbolt](https://godbolt.org/z/KGYcTYr8W)
 ///
@@ -29,13 +98,29 @@ public:
     scope_guard_base(category::proxy proxy, std::string_view event_name_)
         : category_enabled(proxy)
         , event_name(event_name_)
-    {}
-
-    ~scope_guard_base() noexcept {
+    {
         if (category_enabled) {
+            begin = clock::time<>::ticks();
+            started = true;
+        }
+    }
+
+    scope_guard_base(trace_site const& site_, std::string_view event_name_)
+        : scope_guard_base(site_.proxy(), event_name_)
+    {
+        site = &site_;
+    }
+
+protected:
+    ~scope_guard_base() = default;
+
+    /// Called by the derived class' destructor while its members are still alive.
+    void close() noexcept {
+        // the category may be enabled within the scope, which hasn't a valid begin then
+        if (started) {
             try {
                 // e.g. TraceLog's emplace() of vector<TraveEvent> may throw
-                add_event();
+                static_cast<DerivedT&>(*this).add_event();
             }
             catch(std::exception const& e) {
                 std::cerr << "ATTENTION: ~scope_guard() caught: '" << e.what() << "'\n";
@@ -46,6 +131,40 @@ public:
         }
     }
 
+    /// Add a complete event ('X') for the scope lasting @a elapsed clock ticks with the arguments
+    /// given by tuple @a args.
+    template <typename TupleT>
+    void add_complete_event(clock::tick_type elapsed, TupleT const& args) const {
+        std::apply(
+            [this, elapsed](auto const&... arg) {
+                add_trace_event(TraceEvent::phase::COMPLETE, begin, elapsed,
+                                detail::recorded_scope_arg(arg)...);
+            },
+            args);
+    }
+
+    /// Add the event of @a phase to trace log, at the guard's site if there is one.
+    template <typename... ArgsT>
+    void add_trace_event(TraceEvent::phase phase, clock::tick_type timestamp,
+                         clock::tick_type duration, ArgsT const&... args) const {
+        auto& trace_log = TraceLog::GetInstance();
+        if (site != nullptr) {
+            trace_log.AddTraceEvent(                                    // --
+                *site, event_name,                                      // --
+                TraceID::NONE, TraceEvent::flag::NONE,                  // --
+                timestamp, duration,                                    // --
+                args...);
+        }
+        else {
+            trace_log.AddTraceEvent(                                    // --
+                phase,                                                  // --
+                category_enabled.category_name(), event_name,           // --
+                TraceID::NONE, TraceEvent::flag::NONE,                  // --
+                timestamp, duration,                                    // --
+                args...);
+        }
+    }
+
 public:
     scope_guard_base() = delete;
     scope_guard_base(scope_guard_base const&) = delete;
@@ -53,28 +172,17 @@ public:
     scope_guard_base(scope_guard_base&&) = delete;
     scope_guard_base& operator=(scope_guard_base&&) = delete;
 
-private:
-    void add_event() const {
-        auto const& derived = static_cast<DerivedT const&>(*this);
-        // NextGen: always without args API (and order changed)
-        TraceLog::GetInstance().AddTraceEventInternal(              // --
-            TraceEvent::phase::END,                                 // --
-            category_enabled.category_name(), event_name,           // --
-            TraceID::NONE, TraceEvent::flag::NONE,                  // --
-            derived.threshold_begin_id, derived.threshold,          // --
-            nullptr,                                                // --
-            std::string_view{}, trace_value{}                       // -- no arguments
-            );
-    }
-
-private:
+protected:
     category::proxy const category_enabled;
     std::string_view const event_name;
+    trace_site const* site = nullptr;
+    clock::tick_type begin = 0;
+    bool started = false;  // the category was enabled at the begin of scope
 };
 
 ///
 /// Simple scope guard, acts as common API for @ref scope_guard_base, intended to be used
-/// with macros.
+/// with macros. The begin event is added by the user, the guard adds the end event.
 ///
 /// example usage:
 /// @code{.cpp}
@@ -87,6 +195,12 @@ private:
 /// }
 /// @endcode
 ///
+/// or with the end event's call site:
+/// @code{.cpp}
+/// static trace_site const end_site__{ category_proxy__, TraceEvent::phase::END, "event_name" };
+/// auto const scope__ = scope_guard{ end_site__, "event_name" };
+/// @endcode
+///
 class scope_guard : scope_guard_base<scope_guard>
 {
     friend scope_guard_base;
@@ -96,44 +210,162 @@ public:
     : scope_guard_base::scope_guard_base(proxy, event_name)
     {}
 
+    scope_guard(trace_site const& site, std::string_view event_name)
+    : scope_guard_base::scope_guard_base(site, event_name)
+    {}
+
+    ~scope_guard() { close(); }
+
+    scope_guard(scope_guard const&) = delete;
+    scope_guard& operator=(scope_guard const&) = delete;
+    scope_guard(scope_guard&&) = delete;
+    scope_guard& operator=(scope_guard&&) = delete;
+
 private:
-    std::int32_t const threshold_begin_id = TraceLog::EVENT_ID_NONE;
-    clock::duration_type const threshold = clock::duration_zero;
+    void add_event() const {
+        add_trace_event(TraceEvent::phase::END, clock::time<>::ticks(), 0);
+    }
 };
 
 ///
-/// Scope guard with duration threshold, acts as common API for @ref scope_guard_base; intended
+/// Scope guard for complete events, acts as common API for @ref scope_guard_base; intended
 /// to be used with macros.
 ///
+/// Nothing is recorded at the begin of scope, on the end of scope a single complete event ('X')
+/// with the scope's duration and the optional arguments is added to trace log. Compared to the
+/// begin/end pair of @ref scope_guard this halves the buffer usage and the output size.
+///
+/// @note The arguments are stored as given and evaluated at the end of scope, hence string
+/// arguments must stay valid until then. The strings marked by `TraceLog::copy` are copied at the
+/// begin of scope.
+///
 /// example usage:
 /// @code{.cpp}
 /// static auto const category_proxy__ = category::get("category_name");
-/// auto const scope__ = scope_guard{ category_proxy__, "event_name" };
-/// if (category_proxy__) {
-///     auto const id__ = AddTraceEvent(TraceEvent::phase::BEGIN,
-///                   category_proxy__.category_name(), "event_name",
-///                   TraceID::NONE, TraceEvent::flag::NONE, ...);
-///     scope__.set_threshold_begin_id(id__);
-/// }
+/// auto const scope__ = scope_complete_guard{ category_proxy__, "event_name",
+///                                            "arg_name", arg_value };
 /// @endcode
 ///
-///
-class scope_threshold_guard : scope_guard_base<scope_threshold_guard>
+template <typename... ArgsT>
+class scope_complete_guard : scope_guard_base<scope_complete_guard<ArgsT...>>
 {
-    friend scope_guard_base;
+    friend scope_guard_base<scope_complete_guard>;
+
+    using base_type = scope_guard_base<scope_complete_guard>;
 
 public:
-    scope_threshold_guard(category::proxy proxy, std::string_view event_name, clock::duration_type threshold_)
-    : scope_guard_base::scope_guard_base(proxy, event_name)
-    , threshold{ threshold_ }
+    template <typename... InitArgsT>
+    scope_complete_guard(category::proxy proxy, std::string_view event_name,
+                         InitArgsT&&... args_)
+    : base_type::scope_guard_base(proxy, event_name)
+    , args{ detail::capture_scope_arg(this->started, std::forward<InitArgsT>(args_))... }
     {}
 
+    template <typename... InitArgsT>
+    scope_complete_guard(trace_site const& site, std::string_view event_name,
+                         InitArgsT&&... args_)
+    : base_type::scope_guard_base(site, event_name)
+    , args{ detail::capture_scope_arg(this->started, std::forward<InitArgsT>(args_))... }
+    {}
+
+    ~scope_complete_guard() { base_type::close(); }
+
+    scope_complete_guard(scope_complete_guard const&) = delete;
+    scope_complete_guard& operator=(scope_complete_guard const&) = delete;
+    scope_complete_guard(scope_complete_guard&&) = delete;
+    scope_complete_guard& operator=(scope_complete_guard&&) = delete;
+
+private:
+    void add_event() const {
+        base_type::add_complete_event(clock::time<>::ticks() - this->begin, args);
+    }
+
+private:
+    std::tuple<ArgsT...> const args;
+};
+
+template <typename... InitArgsT>
+scope_complete_guard(category::proxy, std::string_view, InitArgsT&&...)
+    -> scope_complete_guard<detail::scope_arg_t<InitArgsT>...>;
+
+template <typename... InitArgsT>
+scope_complete_guard(trace_site const&, std::string_view, InitArgsT&&...)
+    -> scope_complete_guard<detail::scope_arg_t<InitArgsT>...>;
+
+///
+/// Scope guard with duration threshold, acts as common API for @ref scope_guard_base; intended
+/// to be used with macros.
+///
+/// Same as @ref scope_complete_guard, but the complete event is only added if the scope's
+/// duration exceeds the threshold. Hence short scopes cost two clock reads only. The strings
+/// marked by `TraceLog::copy` are copied at the begin of scope.
+///
+/// example usage:
+/// @code{.cpp}
+/// static auto const category_proxy__ = category::get("category_name");
+/// auto const scope__ = scope_threshold_guard{ category_proxy__, "event_name", 42us,
+///                                             "arg_name", arg_value };
+/// @endcode
+///
+template <typename... ArgsT>
+class scope_threshold_guard : scope_guard_base<scope_threshold_guard<ArgsT...>>
+{
+    friend scope_guard_base<scope_threshold_guard>;
+
+    using base_type = scope_guard_base<scope_threshold_guard>;
+
 public:
-    void set_threshold_begin_id(std::int32_t event_id) { threshold_begin_id = event_id; }
+    template <typename... InitArgsT>
+    scope_threshold_guard(category::proxy proxy, std::string_view event_name,
+                          clock::duration_type threshold_, InitArgsT&&... args_)
+    : base_type::scope_guard_base(proxy, event_name)
+    , threshold{ clock::time<>::to_ticks(threshold_) }
+    , args{ detail::capture_scope_arg(this->started, std::forward<InitArgsT>(args_))... }
+    {}
+
+    template <typename... InitArgsT>
+    scope_threshold_guard(trace_site const& site, std::string_view event_name,
+                          clock::duration_type threshold_, InitArgsT&&... args_)
+    : base_type::scope_guard_base(site, event_name)
+    , threshold{ clock::time<>::to_ticks(threshold_) }
+    , args{ detail::capture_scope_arg(this->started, std::forward<InitArgsT>(args_))... }
+    {}
+
+    ~scope_threshold_guard() { base_type::close(); }
+
+    scope_threshold_guard(scope_threshold_guard const&) = delete;
+    scope_threshold_guard& operator=(scope_threshold_guard const&) = delete;
+    scope_threshold_guard(scope_threshold_guard&&) = delete;
+    scope_threshold_guard& operator=(scope_threshold_guard&&) = delete;
 
 private:
-    std::int32_t threshold_begin_id = TraceLog::EVENT_ID_NONE;
-    clock::duration_type const threshold;
+    void add_event() const {
+        auto const elapsed = clock::time<>::ticks() - this->begin;
+
+        if (elapsed < threshold) {
+            return;
+        }
+
+        base_type::add_complete_event(elapsed, args);
+    }
+
+private:
+    clock::tick_type const threshold;  // in clock ticks, saves the conversion on compare
+    std::tuple<ArgsT...> const args;
 };
 
+template <typename... InitArgsT>
+scope_threshold_guard(category::proxy, std::string_view, clock::duration_type, InitArgsT&&...)
+    -> scope_threshold_guard<detail::scope_arg_t<InitArgsT>...>;
+
+template <typename... InitArgsT>
+scope_threshold_guard(trace_site const&, std::string_view, clock::duration_type, InitArgsT&&...)
+    -> scope_threshold_guard<detail::scope_arg_t<InitArgsT>...>;
+
+///
+/// Scope guard placeholder for the categories compiled out by IBIS_TRACE_DISABLED_CATEGORIES,
+/// nothing is recorded and there is no category registered.
+///
+struct null_scope_guard {};
+
 }  // namespace ibis::tool::event_trace
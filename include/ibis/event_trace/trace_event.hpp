@@ -8,12 +8,14 @@
 #include <ibis/event_trace/detail/trace_value.hpp>
 #include <ibis/event_trace/detail/clock.hpp>
 #include <ibis/event_trace/detail/platform.hpp>
+#include <ibis/event_trace/detail/thread_registry.hpp>
 
 #include <string_view>
 #include <vector>
 #include <memory>
 #include <array>
 #include <type_traits>
+#include <cstring>
 
 #include <atomic>
 #include <random>
@@ -34,9 +36,75 @@ template<typename... T> concept CountArgT = requires(T... args) { // concept: ht
     requires (sizeof...(T)) / (2*IBIS_TRACE_EVENT_MAX_ARGS+1) == 0;
 };
 
+///
+/// The argument (key : value) of a trace event. The arguments are stored outside of the
+/// TraceEvent in the event chunk's arena. This side area holds the arguments' names and value
+/// payloads, followed by the array of the values' type tags.
+///
+struct trace_arg {
+    char const* name;
+    trace_value::payload_type value;
+
+    /// Size of the side area for @a count arguments.
+    static constexpr std::size_t storage_size(std::size_t count)
+    {
+        return count * (sizeof(trace_arg) + sizeof(trace_value::type));
+    }
+
+    /// Store the argument at @a index into the side area of @a count arguments at @a args.
+    static void store(trace_arg* args, std::size_t count, std::size_t index,  // --
+                      char const* name, trace_value value)
+    {
+        args[index] = trace_arg{ name, value.data() };
+        tags(args, count)[index] = value.type_tag();
+    }
+
+    /// Load the value at @a index from the side area of @a count arguments at @a args.
+    static trace_value load(trace_arg const* args, std::size_t count, std::size_t index)
+    {
+        return trace_value(tags(args, count)[index], args[index].value);
+    }
+
+private:
+    static trace_value::type* tags(trace_arg* args, std::size_t count)
+    {
+        return reinterpret_cast<trace_value::type*>(args + count);  // NOLINT
+    }
+
+    static trace_value::type const* tags(trace_arg const* args, std::size_t count)
+    {
+        return reinterpret_cast<trace_value::type const*>(args + count);  // NOLINT
+    }
+};
+
+static_assert(std::is_trivially_destructible_v<trace_arg>,
+              "trace_arg is stored in arena, its destructor is never called");
+
+class trace_site;
+
+namespace detail {
+class binary_writer;
+class perfetto_writer;
+}
+
+///
+/// The surrounding of the trace events required for their serialization, set up once per flush
+/// and event chunk.
+///
+struct flush_context {
+    thread_registry const& threads;
+    current_proc::id_type process_id;
+    thread_registry::index_type thread_index;  ///< the chunk's recording thread
+    clock::tick_type base_time;                ///< the chunk's base time
+    std::string_view pid_tid;                  ///< JSON only, preformatted '"pid":..,"tid":..'
+};
+
 ///
 /// The trace event to be stored.
 ///
+/// The event is kept compact to hold much events in cache, the arguments are stored in a side
+/// area and referred by pointer.
+///
 class TraceEvent {
 public:
     /// Phase indicates the nature of an event entry. E.g. part of a begin/end pair.
@@ -58,12 +126,10 @@ public:
         NONE = 0,
         HAS_ID = 1U << 0U,
         MANGLE_ID = 1U << 1U,
+        HAS_SITE = 1U << 2U,  ///< recorded at a trace_site, set by the constructor
+        FULL_TIME = 1U << 3U, ///< time stamp out of the chunk's delta range, see TraceEvent()
     };
 
-public:
-    //NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
-    using storage_ptr = std::unique_ptr<char[]>;
-
 public:
     TraceEvent() = delete;
     TraceEvent(TraceEvent const&) = delete;
@@ -75,49 +141,98 @@ public:
     ~TraceEvent() = default;
 
 public:
-    TraceEvent(current_thread::id_type thread_id, clock::time_point_type timestamp,
+    /// The event's time stamp is the @a time_delta relative to the base time of its chunk, also
+    /// the recording thread is a property of the chunk. COMPLETE events are recorded at their end,
+    /// the begin is derived from the @a duration. With flag FULL_TIME the time stamp is out of the
+    /// chunk's delta range, it's stored in the side area ahead of the @a args instead. Only thread
+    /// name's METADATA events are recorded by another thread, these carry the index of the named
+    /// thread as @a trace_id. Events recorded at a call @a site refer to the site's category and
+    /// JSON fragments.
+    TraceEvent(std::uint32_t time_delta, clock::tick_type duration,              // --
                TraceEvent::phase phase,                                      // --
                std::string_view category_name, std::string_view event_name,  // --
                std::uint64_t trace_id, TraceEvent::flag flags_,              // --
-               storage_ptr ptr,                                              //
-               std::string_view arg1_name, trace_value arg1_value
+               trace_arg const* args, std::size_t arg_count,                 // --
+               trace_site const* site = nullptr
     )
-    : category_name_(category_name.data())
-    , event_name_(event_name.data())
-    //, arg_names(arg1_name)
-    //, arg_values(arg1_value)
-    , thread_id_(thread_id)
-    , timestamp_(timestamp)
-    , trace_id_(trace_id)
-    , copy_storage(std::move(ptr))
+    : event_name_(event_name.data())
+    , args_(args)
+    , time_delta_(time_delta)
     , phase_(phase)
     , flags(flags_)
+    , arg_count_(static_cast<std::uint8_t>(arg_count))
     {
         // check on correct terminated string literals since storage is using C strings
-        assert(strlen(category_name_) == category_name.size() && "unexpected strlen for category_name");
+        assert(strlen(category_name.data()) == category_name.size() && "unexpected strlen for category_name");
         assert(strlen(event_name_) == event_name.size() && "unexpected strlen for event_name");
+        assert(arg_count <= ARGS_SZ && "too many arguments");
 
-        // FIXME compile fix during transition to new API
-        arg_names[0] = arg1_name.data();
-        arg_values[0] = arg1_value;
-        // FIXME this must be variadic! also, this is bullshit!
-        if (arg_names[0] != nullptr) {
-            assert(strlen(arg_names[0]) == arg1_name.size() && "unexpected strlen for arg_name");
+        // the category name is also known by the site
+        if (site != nullptr) {
+            site_ = site;
+            flags = static_cast<TraceEvent::flag>(flags | TraceEvent::flag::HAS_SITE);
+        }
+        else {
+            category_name_ = category_name.data();
+        }
+
+        // the trace ID and duration share their storage
+        if (phase == TraceEvent::phase::COMPLETE) {
+            assert((flags & TraceEvent::flag::HAS_ID) == 0 && "complete events can't have an ID");
+            duration_ = duration;
+        }
+        else {
+            trace_id_ = trace_id;
         }
     }
 
 public:
-    // Serialize event data to JSON
-    void AppendAsJSON(std::string& out) const;
+    // Serialize event data to JSON, the @a context is the one of the event's chunk.
+    void AppendAsJSON(std::string& out, flush_context const& context) const;
+
+    // Serialize event data to the binary format, the @a context is the one of the event's chunk.
+    void AppendAsBinary(detail::binary_writer& out, flush_context const& context) const;
+
+    // Serialize event data to Perfetto's track events, the @a context is the one of the event's
+    // chunk.
+    void AppendAsPerfetto(detail::perfetto_writer& out, flush_context const& context) const;
 
 public:
-    clock::time_point_type timestamp() const { return timestamp_; }
+    /// The raw clock ticks, for COMPLETE events the begin; see clock::time<>::to_time_point().
+    /// The @a base_time is the one of the event's chunk.
+    clock::tick_type timestamp(clock::tick_type base_time) const
+    {
+        clock::tick_type recorded = base_time + time_delta_;
+        if ((flags & TraceEvent::flag::FULL_TIME) != 0) {
+            std::memcpy(&recorded, full_time(), sizeof(recorded));
+        }
+        if (phase_ == TraceEvent::phase::COMPLETE) {
+            return recorded - duration_;
+        }
+        return recorded;
+    }
+
+    /// The time stamp in nanoseconds, as written by the serialization.
+    std::int64_t timestamp_ns(clock::tick_type base_time) const;
+
+    /// The duration of COMPLETE events in nanoseconds, as written by the serialization.
+    std::int64_t duration_ns() const;
 
     std::string_view name() const { return event_name_; }
 
+    std::string_view category_name() const;
+
 public:
     static constexpr std::size_t const ARGS_SZ = IBIS_TRACE_EVENT_MAX_ARGS;
 
+private:
+    /// The full time stamp stored in the side area, ahead of the arguments.
+    char const* full_time() const
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        return reinterpret_cast<char const*>(args_) - sizeof(clock::tick_type);
+    }
+
 private:
     // Note: use of raw char pointer to save space, sizeof(std::string_view{}) > sizeof(char const*),
     // e.g. 16 vs. 8 bytes.
@@ -125,22 +240,29 @@ private:
 
 private:
     // these are ordered by size (largest first) for optimal aligned storage.
-    std::array<trace_value, ARGS_SZ> arg_values;   // MAX_ARGS * 16 bytes
-    std::array<string_type, ARGS_SZ> arg_names = { nullptr };    // MAX_ARGS * 8 bytes
+    union {
+        string_type category_name_ = nullptr;  // 8 bytes
+        trace_site const* site_;               // 8 bytes, if HAS_SITE
+    };
+    string_type event_name_;  // 8 bytes
 
-    string_type category_name_;  // 8 bytes
-    string_type event_name_;     // 8 bytes
+    union {
+        std::uint64_t trace_id_ = 0;        // 8 bytes, if HAS_ID or the METADATA's thread index
+        clock::tick_type duration_;         // 8 bytes, COMPLETE only, raw clock ticks
+    };
 
-    current_thread::id_type thread_id_ = current_thread::UNKNOWN;   // 8 bytes
-    clock::time_point_type timestamp_ = clock::time_point_zero;     // 8 bytes
-    std::uint64_t trace_id_ = 0;                                    // 8 bytes
+    trace_arg const* args_ = nullptr;  // 8 bytes, side area in the chunk's arena
 
-    storage_ptr copy_storage = nullptr;  // 8 bytes
+    std::uint32_t time_delta_ = 0;  // 4 bytes, raw clock ticks relative to the chunk's base time,
+                                    // unused if FULL_TIME
 
     TraceEvent::phase phase_ = TraceEvent::phase::UNSPECIFIED;  // 1 byte
     TraceEvent::flag flags = TraceEvent::flag::NONE;            // 1 byte
+    std::uint8_t arg_count_ = 0;                                // 1 byte
 };
 
+static_assert(sizeof(TraceEvent) <= 40, "TraceEvent exceeds its size budget");
+
 }  // namespace ibis::tool::event_trace
 
 //
@@ -6,13 +6,29 @@
 #pragma once
 
 #include <ibis/event_trace/trace_event.hpp>
+#include <ibis/event_trace/trace_site.hpp>
+#include <ibis/event_trace/detail/event_chunk.hpp>
+#include <ibis/event_trace/detail/thread_registry.hpp>
+#include <ibis/event_trace/detail/string_pool.hpp>
+#include <ibis/event_trace/detail/worker_pool.hpp>
+#include <ibis/event_trace/detail/binary_writer.hpp>
+#include <ibis/event_trace/detail/perfetto_writer.hpp>
 #include <ibis/event_trace/detail/platform.hpp>
 
 #include <vector>
+#include <deque>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
 #include <functional>
 #include <string_view>
+#include <span>
+#include <array>
+#include <tuple>
+#include <utility>
 #include <iostream>
 #include <cstring>
 
@@ -28,6 +44,7 @@ class TraceLog {
 
 private:
     TraceLog();
+    ~TraceLog();
 
 public:
     static TraceLog& GetInstance()
@@ -74,18 +91,35 @@ public:
         operator trace_value() const { return trace_value(sv); }
 
     private:
-        /// Get the size of the string including terminating '\0'.
-        std::size_t alloc_size() const { return sv.size() + 1; }
+        /// Get the size of the string including terminating '\0', zero if the string is
+        /// interned already.
+        std::size_t alloc_size() const { return interned ? 0 : sv.size() + 1; }
+
+        /// Rebind to the pooled copy of the string, if it's possible to intern it.
+        void intern(detail::string_pool* pool)
+        {
+            if (pool == nullptr) {
+                return;
+            }
+            if (auto const pooled = pool->intern(sv); pooled.data() != nullptr) {
+                sv = pooled;
+                interned = true;
+            }
+        }
 
         /// Makes a '\0' terminated deep copy of the string specified at construction time, then
         /// the object is represented by the new memory address.
-        void deep_copy(TraceEvent::storage_ptr& base_ptr, std::size_t& start_offset)
+        void deep_copy(char* base_ptr, std::size_t& start_offset)
         {
-            auto* raw_ptr = base_ptr.get() + start_offset;
+            if (interned) {
+                return;
+            }
+
+            auto* raw_ptr = base_ptr + start_offset;
 
             // '\0' terminated deep copy
             auto const count = sv.copy(raw_ptr, sv.size());
-            base_ptr[start_offset + count] = '\0';
+            raw_ptr[count] = '\0';
 
             // rebind to storage pointer
             this->sv = std::move(std::string_view(raw_ptr, count));
@@ -95,12 +129,12 @@ public:
 
     private:
         std::string_view sv;
+        bool interned = false;
     };
 
 public:
-    /// Event identifier to express that there is none valid ID. The ID gets a meaning, if a
-    /// TraceEvent is to be recorded, if a given time is exceeded (namely
-    /// TraceEndOnScopeCloseThreshold). Then the ID of the beginning event.
+    /// Event identifier to express that there is none valid ID, e.g. the event wasn't recorded.
+    /// Note, event IDs are a per thread sequence.
     static constexpr int32_t EVENT_ID_NONE = -1;
 
 public:
@@ -117,48 +151,53 @@ public:
 
 public:
     ///
-    /// @brief Adds an overloaded TraceEvent without arguments.
+    /// @brief Adds a TraceEvent with up to IBIS_TRACE_EVENT_MAX_ARGS arguments.
+    ///
+    /// The strings marked by `TraceLog::copy` are detected at compile time: without any of them
+    /// no allocation code is generated at all, otherwise the copied strings not interned are
+    /// deep copied into one single allocation.
     ///
     /// @tparam EventNameT Type of the event_name, basically convertible  to string.
+    /// @tparam ArgsT Types of the arguments, pairs of key name (basically convertible to string)
+    /// and argument value.
     /// @param phase TraceEvent's phase to indicate the nature of an event entry.
     /// @param category_name Category name.
     /// @param event_name Event name.
     /// @param trace_id TraceLog's ID for tracing.
     /// @param flags TraceEvent's flags.
-    /// @param threshold_begin_id Event ID at begin of threshold timing scope.
-    /// @param threshold The threshold value.
+    /// @param timestamp The event's clock ticks, for complete events the begin of the scope.
+    /// @param duration The duration ticks of complete events, otherwise zero.
+    /// @param args The optional arguments as sequence of key name and value.
     /// @return The TraceLog ID.
     ///
-    std::int32_t AddTraceEvent(                                         // --
-        TraceEvent::phase phase,                                        // --
-        std::string_view category_name, std::string_view event_name,    // --
-        std::uint64_t trace_id, TraceEvent::flag flags,                 // --
-        std::int32_t threshold_begin_id, clock::duration_type threshold);
+    template <typename EventNameT, typename... ArgsT>
+    requires CountArgT<ArgsT...>
+    std::int32_t AddTraceEvent(                                          // --
+        TraceEvent::phase phase,                                         // --
+        std::string_view category_name, EventNameT event_name,           // --
+        std::uint64_t trace_id, TraceEvent::flag flags,                  // --
+        clock::tick_type timestamp, clock::tick_type duration,           // --
+        ArgsT... args)
+    {
+        return AddTraceEventAt(nullptr, phase, category_name, event_name,  // --
+                               trace_id, flags, timestamp, duration, args...);
+    }
 
     ///
-    /// Adds an overloaded TraceEvent for arguments.
-    ///
-    /// @tparam Arg1_KeyT Type of the key name, basically convertible to string.
-    /// @tparam Arg1_ValueT Type of the argument value.
-    /// @param phase TraceEvent's phase to indicate the nature of an event entry.
-    /// @param category_name Category name.
-    /// @param event_name Event name.
-    /// @param trace_id TraceLog's ID for tracing.
-    /// @param flags TraceEvent's flags.
-    /// @param arg1_name Key name of the optional argument.
-    /// @param arg1_value Value of the optional argument.
-    /// @param threshold_begin_id Event ID at begin of threshold timing scope.
-    /// @param threshold The threshold value.
-    /// @return The TraceLog ID.
+    /// Adds an event recorded at the call @a site, which provides the phase and category name.
+    /// Otherwise the same as above.
     ///
-    template <typename Arg1_KeyT, typename Arg1_ValueT>
-    std::int32_t AddTraceEvent(                                         // --
-        TraceEvent::phase phase,                                        // --
-        std::string_view category_name, std::string_view event_name,    // --
-        std::uint64_t trace_id, TraceEvent::flag flags,                 // --
-        std::int32_t threshold_begin_id, clock::duration_type threshold, // --
-        Arg1_KeyT arg1_name, Arg1_ValueT arg1_value                     // --
-        );
+    template <typename EventNameT, typename... ArgsT>
+    requires CountArgT<ArgsT...>
+    std::int32_t AddTraceEvent(                                          // --
+        trace_site const& site, EventNameT event_name,                   // --
+        std::uint64_t trace_id, TraceEvent::flag flags,                  // --
+        clock::tick_type timestamp, clock::tick_type duration,           // --
+        ArgsT... args)
+    {
+        return AddTraceEventAt(&site, site.phase(), site.category_name(), event_name,  // --
+                               trace_id, flags, timestamp, duration, args...);
+    }
 
     ///
     /// Adds a concrete event to the log.
@@ -168,20 +207,23 @@ public:
     /// @param event_name Event name.
     /// @param trace_id TraceLog's ID for tracing.
     /// @param flags TraceEvent's flags.
-    /// @param arg1_name Key name of the optional argument.
-    /// @param arg1_value Value of the optional argument.
-    /// @param threshold_begin_id Event ID at begin of threshold timing scope.
-    /// @param threshold The threshold value.
-    /// @param ptr A smart pointer to the copied string data.
+    /// @param timestamp The event's clock ticks, for complete events the begin of the scope.
+    /// @param duration The duration ticks of complete events, otherwise zero.
+    /// @param chunk The calling thread's chunk, which also holds the copied string data.
+    /// @param arg_names Key names of the optional arguments.
+    /// @param arg_values Values of the optional arguments, same count as @a arg_names.
+    /// @param site The call site of the event, if any.
     /// @return std::int32_t
     ///
     std::int32_t AddTraceEventInternal(                                   // --
         TraceEvent::phase phase,                                          // --
         std::string_view category_name, std::string_view event_name,      // --
         std::uint64_t trace_id, TraceEvent::flag flags,                   // --
-        std::int32_t threshold_begin_id, clock::duration_type threshold,  // --
-        TraceEvent::storage_ptr ptr,                                      // --
-        std::string_view arg1_name, trace_value arg1_value                // --        
+        clock::tick_type timestamp, clock::tick_type duration,            // --
+        event_chunk* chunk,                                               // --
+        std::span<std::string_view const> arg_names,                      // --
+        std::span<trace_value const> arg_values,                          // --
+        trace_site const* site = nullptr                                  // --
         );
 
 public:
@@ -197,17 +239,97 @@ public:
     bool IsEnabled() const { return enabled_; }
 
 public:
-    std::size_t GetEventsCount() const { return logged_events_.size(); }
+    /// Policy on exhausted event buffer.
+    enum class buffer_mode : std::uint8_t {
+        FILL,   ///< Record until the buffer is full, newer events are discarded (default).
+        RING    ///< Flight recorder, the oldest events are overwritten by the newer ones.
+    };
+
+    ///
+    /// Set the event buffer's policy.
+    ///
+    /// @param mode The buffer policy.
+    /// @param event_count The number of events to be kept in memory, rounded up to whole event
+    /// chunks and limited to the (default) BUFFER_SZ.
+    /// @param max_age Only events recorded within this time window before Flush() are written,
+    /// a zero duration disables the time window. Only used on buffer_mode::RING.
+    ///
+    /// @note In ring mode only chunks handed over by the recording threads can be overwritten,
+    /// hence @a event_count should be chosen larger than the number of recording threads times
+    /// event_chunk::CHUNK_SZ. On lowering the buffer size, the chunks in use are released after
+    /// they are flushed.
+    ///
+    void SetBufferMode(buffer_mode mode, std::size_t event_count = BUFFER_SZ,
+                       clock::duration_type max_age = clock::duration_zero);
+
+public:
+    std::size_t GetEventsCount() const;
     float GetEventBufferPercentFull() const;
 
 public:
-    /// Flushes all logged data to the callback.
+    /// Flushes all logged data to the callback. These are the events of the chunks handed back
+    /// by the recording threads and the events published so far by the chunks still bound to
+    /// their threads, also of the idle or blocked ones. The threads hand over their chunk with
+    /// the next event recorded or on thread exit, the events flushed already are skipped then.
     void Flush();
 
-    /// simply annotates the stream with "[" and "]" respectively
+    ///
+    /// Serialize the events on Flush() by a pool of threads, the output is the same as of the
+    /// serial flush. The batches of events are serialized in parallel into own buffers, which
+    /// are passed in the original order to the output callback by the flushing thread.
+    ///
+    /// @param thread_count Number of threads serializing, including the flushing thread. A
+    /// count of 0 or 1 disables the parallel flush (default).
+    ///
+    void SetFlushThreads(std::size_t thread_count);
+
+public:
+    /// The format of the data passed to the output callback.
+    enum class output_format : std::uint8_t {
+        JSON,     ///< Chrome's JSON trace format (default).
+        BINARY,   ///< Compact binary format, see binary_to_json() to convert it to JSON.
+        PERFETTO  ///< Perfetto's protobuf TracePacket format, e.g. for the Perfetto UI.
+    };
+
+    ///
+    /// Set the format of the trace written, takes effect with the next BeginLogging().
+    ///
+    /// The binary format writes each category and event name once into a string table, the time
+    /// stamps as varint encoded deltas and the arguments typed. It's serialized by the flushing
+    /// thread only, since the string table and the time stamp deltas depend on the order.
+    ///
+    /// The Perfetto format is serialized by the flushing thread too, the names are interned on
+    /// the packet sequence. The complete events are written as slice begin and end, the counter
+    /// events as a counter track for each argument.
+    ///
+    void SetOutputFormat(output_format format);
+
+    /// simply annotates the stream with "[" and "]" respectively. EndLogging() stops the
+    /// background flusher, if running. The strings copied by TraceLog::copy are interned during
+    /// the trace session begun by BeginLogging(), which also initializes the clock source.
     void BeginLogging();
     void EndLogging();
 
+public:
+    ///
+    /// Start a background thread, which flushes the events handed over by the recording threads.
+    /// Hence the serialization and the output callback's I/O is done off the recording threads,
+    /// also for SetEnabled() and BufferFullCallback().
+    ///
+    /// @param fill_level The flusher is woken up if the fraction of the event buffer, which is
+    /// handed over by the recording threads, reaches this level (0.0 ... 1.0).
+    /// @param interval The flusher is woken up periodically, a zero duration disables the timer.
+    ///
+    void StartFlusher(float fill_level = 0.5F,
+                      clock::duration_type interval = std::chrono::seconds(1));
+
+    /// Stop the background flusher thread after a final flush of the events handed over. The
+    /// flusher must be stopped before the static destruction, e.g. by EndLogging(), otherwise it's
+    /// stopped by TraceLog's destructor without flushing.
+    void StopFlusher();
+
+    bool IsFlusherRunning() const { return flusher_running_.load(std::memory_order_relaxed); }
+
     // private:
     void AddThreadNameMetadataEvents();
 
@@ -219,6 +341,66 @@ private:
     /// Number of events to flush at once.
     static constexpr std::size_t BATCH_SZ = 1000;
 
+    /// Number of batches serialized in parallel per flush pool's thread, before the output.
+    static constexpr std::size_t BATCHES_PER_THREAD = 4;
+
+    /// Maximal number of per thread event chunks to be allocated.
+    static constexpr std::size_t MAX_CHUNKS = BUFFER_SZ / event_chunk::CHUNK_SZ;
+
+private:
+    /// The thread's event chunk, handed back to TraceLog on thread exit.
+    struct thread_local_chunk {
+        ~thread_local_chunk();
+
+        event_chunk* chunk = nullptr;
+        std::int32_t next_event_id = 0;     // thread's event sequence
+        bool exhausted = false;             // no chunk available at last attempt
+        std::uint32_t exhausted_generation = 0;
+    };
+
+    /// Get the calling thread's chunk to record an event into. A new one is acquired if there is
+    /// none, the current is full or outdated by a flush. On exhausted buffer nullptr is returned.
+    event_chunk* thread_chunk();
+
+    /// Common implementation of the AddTraceEvent() overloads, @a site may be nullptr.
+    template <typename EventNameT, typename... ArgsT>
+    requires CountArgT<ArgsT...>
+    std::int32_t AddTraceEventAt(                                        // --
+        trace_site const* site, TraceEvent::phase phase,                 // --
+        std::string_view category_name, EventNameT event_name,           // --
+        std::uint64_t trace_id, TraceEvent::flag flags,                  // --
+        clock::tick_type timestamp, clock::tick_type duration,           // --
+        ArgsT... args);
+
+    /// Slow path of thread_chunk(), hand over the current chunk and acquire a new one.
+    event_chunk* swap_chunk(thread_local_chunk& local);
+
+    /// Hand over the chunk for flushing, requires the lock_ to be held.
+    void retire_chunk(thread_local_chunk& local);
+
+    /// Clear the chunk and put it back to the pool, the chunk is released if the pool exceeds
+    /// the buffer size; requires the lock_ to be held.
+    void recycle_chunk(event_chunk* chunk);
+
+    /// Get an unbound chunk from the pool, allocate a new one or overwrite the oldest one on
+    /// ring buffer mode; requires the lock_ to be held.
+    event_chunk* allocate_chunk();
+
+    /// Check the fill level to wake up the background flusher; requires the lock_ to be held.
+    bool flush_required() const;
+
+    /// Wake up the background flusher thread, false if there is none running (anymore).
+    bool request_flush();
+
+    /// Stop the background flusher thread, with a final flush if @a final_flush is set.
+    void stop_flusher(bool final_flush);
+
+    /// Flush if there is no background flusher, otherwise request it to do the job.
+    void flush_or_request();
+
+    /// background flusher's thread function.
+    void flusher_loop();
+
 private:
     /// Collect the amount of memory to be allocated if T is of copy-marker-type
     /// `TraceLog::copy`, otherwise nothings is done.
@@ -231,22 +413,31 @@ private:
         return alloc_size;
     }
 
-    /// Allocate memory of size @a alloc_size if required, otherwise ```nullptr``` is returned.
-    static TraceEvent::storage_ptr allocate(std::size_t alloc_size)
+    /// Intern the string if T is of copy-marker-type `TraceLog::copy` and there is a string
+    /// @a pool, otherwise nothing is done. Interned strings don't require memory to be allocated.
+    template <typename T>
+    static void intern(detail::string_pool* pool, T& str)
+    {
+        if constexpr (std::is_same_v<std::decay_t<decltype(str)>, TraceLog::copy>) {
+            str.intern(pool);
+        }
+    }
+
+    /// Allocate memory of size @a alloc_size from the @a storage arena if required, otherwise
+    /// ```nullptr``` is returned.
+    static char* allocate(detail::arena& storage, std::size_t alloc_size)
     {
-        TraceEvent::storage_ptr ptr = nullptr;
-        if (alloc_size != 0) {
-            // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
-            ptr = std::make_unique<char[]>(alloc_size);
+        if (alloc_size == 0) {
+            return nullptr;
         }
-        return ptr;
+        return storage.allocate(alloc_size);
     }
 
     /// make deep copy if T is of copy-marker-type `TraceLog::copy`, otherwise nothings is done.
     /// Note, in this case @str is modified, using the storage @a base_ptr as new memory for the
     /// string data.
     template <typename T>
-    static void deep_copy(TraceEvent::storage_ptr& base_ptr, std::size_t& offset, T& str)
+    static void deep_copy(char* base_ptr, std::size_t& offset, T& str)
     {
         if constexpr (std::is_same_v<std::decay_t<decltype(str)>, TraceLog::copy>) {
             str.deep_copy(base_ptr, offset);
@@ -257,14 +448,63 @@ private:
     static inline output_callback_type output_callback = [](std::string_view) {};
 
 private:
-    std::mutex lock_;
+    static thread_local thread_local_chunk current_chunk_;
+
+    /// Guards the chunk lists below, never taken on recording except on chunk hand over.
+    std::mutex mutable lock_;
+
+    /// Serializes concurrent Flush() calls, also guards the flush_pool_.
+    std::mutex flush_lock_;
+
+    /// Threads of the parallel flush, nullptr on serial flush.
+    std::unique_ptr<detail::worker_pool> flush_pool_;
+
+    /// The format requested and the one of the current trace session, also guarded by
+    /// flush_lock_. The binary and the Perfetto writer hold the string tables of the session.
+    output_format output_format_ = output_format::JSON;
+    output_format session_format_ = output_format::JSON;
+    std::unique_ptr<detail::binary_writer> binary_writer_;
+    std::unique_ptr<detail::perfetto_writer> perfetto_writer_;
+
+    /// The events of a chunk to be flushed, the chunk may be still bound to its thread.
+    struct flush_range {
+        event_chunk* chunk;
+        std::size_t begin;
+        std::size_t end;
+        bool bound;
+    };
 
-    std::vector<TraceEvent> logged_events_;
-    std::vector<TraceEvent> flush_events_;
+    std::vector<std::unique_ptr<event_chunk>> chunks_;  // owns all chunks
+    std::vector<event_chunk*> free_chunks_;
+    std::vector<event_chunk*> bound_chunks_;            // recording threads' chunks
+    std::deque<event_chunk*> retired_chunks_;
+    std::vector<flush_range> flush_chunks_;
+
+    /// Incremented by Flush() to request the recording threads to hand over their chunks.
+    std::atomic<std::uint32_t> generation_ = 0;
+
+    buffer_mode buffer_mode_ = buffer_mode::FILL;
+    std::size_t max_chunks_ = MAX_CHUNKS;
+    clock::duration_type max_age_ = clock::duration_zero;
+
+    /// Background flusher, the mutex guards the flusher's state below.
+    std::thread flusher_;
+    std::mutex flusher_mutex_;
+    std::condition_variable flusher_cv_;
+    std::atomic<bool> flusher_running_ = false;
+    bool flusher_stop_ = false;
+    bool flusher_final_flush_ = true;
+    bool flush_requested_ = false;
+    float flusher_fill_level_ = 0.5F;
+    clock::duration_type flusher_interval_ = clock::duration_zero;
 
     current_proc::id_type process_id_;
 
-    std::vector<current_thread::id_type> thread_ids_seen;
+    /// The threads seen recording events, used for thread name metadata.
+    thread_registry thread_registry_;
+
+    /// The trace session's pool of interned strings, handed over to the chunks on binding.
+    std::shared_ptr<detail::string_pool> string_pool_;
 
     // Process ID Hash as TraceID to make it unlikely to collide with other processes.
     std::size_t process_id_hash_;
@@ -286,74 +526,87 @@ inline constexpr bool valid_string_arg_v = valid_string_arg<T>::value;
 
 /// ---
 
-inline std::int32_t TraceLog::AddTraceEvent(                        // --
-    TraceEvent::phase phase,                                        // --
-    std::string_view category_name, std::string_view event_name,    // --
-    std::uint64_t trace_id, TraceEvent::flag flags,                 // --
-    std::int32_t threshold_begin_id, clock::duration_type threshold)
+/// Test if any of T is of copy-marker-type `TraceLog::copy`.
+template <typename... T>
+inline constexpr bool has_copy_arg_v =
+    (std::is_same_v<std::decay_t<T>, TraceLog::copy> || ...);
+
+template <typename EventNameT, typename... ArgsT>
+requires CountArgT<ArgsT...>
+inline std::int32_t TraceLog::AddTraceEventAt(                       // --
+    trace_site const* site, TraceEvent::phase phase,                 // --
+    std::string_view category_name, EventNameT event_name,           // --
+    std::uint64_t trace_id, TraceEvent::flag flags,                  // --
+    clock::tick_type timestamp, clock::tick_type duration,           // --
+    ArgsT... args)
 {
-    //static_assert(valid_string_arg_v<EventNameT>, "Wrong Type for 'event_name' argument");
+    static_assert(valid_string_arg_v<EventNameT>, "Wrong Type for 'event_name' argument");
 
-    std::size_t alloc_size = 0;
-    std::size_t offset = 0;
+    constexpr std::size_t arg_count = sizeof...(ArgsT) / 2;
 
-    // collect the amount of memory to be allocated ...
-    accumulate_size(alloc_size, event_name);
+    // the copied strings are stored along with the event in the thread's chunk
+    auto* const chunk = thread_chunk();
 
-    // ... allocate if required ...
-    TraceEvent::storage_ptr ptr = allocate(alloc_size);
+    if (chunk == nullptr) {
+        return TraceLog::EVENT_ID_NONE;
+    }
 
-    // ... and make deep copy if required
-    deep_copy(ptr, offset, event_name);
+    if constexpr (has_copy_arg_v<EventNameT, ArgsT...>) {
+        std::size_t alloc_size = 0;
+        std::size_t offset = 0;
 
-    return AddTraceEventInternal(               // --
-        phase,                                  // --
-        category_name, event_name,              // --
-        trace_id, flags,                        // --
-        threshold_begin_id, threshold,          // --
-        std::move(ptr),                         // --
-        std::string_view{}, trace_value{}       // -- no argument        
-        );
-}
+        // intern the strings to be copied if possible, ...
+        auto* const pool = chunk->interned_strings();
+        intern(pool, event_name);
+        (intern(pool, args), ...);
 
-template <typename Arg1_KeyT, typename Arg1_ValueT>
-inline std::int32_t TraceLog::AddTraceEvent(                        // --
-    TraceEvent::phase phase,                                        // --
-    std::string_view category_name, std::string_view event_name,    // --
-    std::uint64_t trace_id, TraceEvent::flag flags,                 // --
-    std::int32_t threshold_begin_id, clock::duration_type threshold, // --
-    Arg1_KeyT arg1_name, Arg1_ValueT arg1_value                     // --
-    )
-{
-    //static_assert(valid_string_arg_v<EventNameT>, "Wrong Type for 'event_name' argument");
-    static_assert(valid_string_arg_v<Arg1_KeyT>, "Wrong Type for 'arg1_name' argument");
-
-    // FIXME: with variadic templates allocate must be rewritten. Maybe move to own class
-    // which simplifies testing.
-    std::size_t alloc_size = 0;
-    std::size_t offset = 0;
-
-    // collect the amount of memory to be allocated ...
-    accumulate_size(alloc_size, event_name);
-    accumulate_size(alloc_size, arg1_name);
-    accumulate_size(alloc_size, arg1_value);
-
-    // ... allocate ...
-    TraceEvent::storage_ptr ptr = allocate(alloc_size);
-
-    // ... and make deep copy.
-    deep_copy(ptr, offset, event_name);
-    deep_copy(ptr, offset, arg1_name);
-    deep_copy(ptr, offset, arg1_value);
-
-    return AddTraceEventInternal(           // --
-        phase,                              // --
-        category_name, event_name,          // --
-        trace_id, flags,                    // --
-        threshold_begin_id, threshold,      // --
-        std::move(ptr),                     // --
-        arg1_name, arg1_value               // -- argument (key : value)
-        );
+        // ... collect the amount of memory to be allocated for the remaining ...
+        accumulate_size(alloc_size, event_name);
+        (accumulate_size(alloc_size, args), ...);
+
+        // ... allocate once if required ...
+        char* const ptr = allocate(chunk->side_storage(), alloc_size);
+
+        // ... and make deep copy.
+        deep_copy(ptr, offset, event_name);
+        (deep_copy(ptr, offset, args), ...);
+    }
+
+    if constexpr (arg_count == 0) {
+        return AddTraceEventInternal(           // --
+            phase,                              // --
+            category_name, event_name,          // --
+            trace_id, flags,                    // --
+            timestamp, duration,                // --
+            chunk,                              // --
+            {}, {},                             // -- no argument
+            site                                // --
+            );
+    }
+    else {
+        // split the sequence of key names and values
+        auto const arg_tuple = std::tie(args...);
+
+        auto const [arg_names, arg_values] =
+            [&arg_tuple]<std::size_t... I>(std::index_sequence<I...>) {
+                static_assert((valid_string_arg_v<std::tuple_element_t<2 * I, std::tuple<ArgsT...>>> && ...),
+                              "Wrong Type for 'arg_name' argument");
+                return std::pair{
+                    std::array<std::string_view, arg_count>{ std::get<2 * I>(arg_tuple)... },
+                    std::array<trace_value, arg_count>{ trace_value(std::get<2 * I + 1>(arg_tuple))... }
+                };
+            }(std::make_index_sequence<arg_count>{});
+
+        return AddTraceEventInternal(           // --
+            phase,                              // --
+            category_name, event_name,          // --
+            trace_id, flags,                    // --
+            timestamp, duration,                // --
+            chunk,                              // --
+            arg_names, arg_values,              // -- arguments (key : value)
+            site                                // --
+            );
+    }
 }
 
 }  // namespace ibis::tool::event_trace
@@ -0,0 +1,115 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#pragma once
+
+#include <ibis/event_trace/trace_event.hpp>
+#include <ibis/event_trace/category.hpp>
+
+#include <string_view>
+#include <type_traits>
+
+namespace ibis::tool::event_trace {
+
+///
+/// Static data of a trace macro's call site.
+///
+/// At a call site the category, the phase and (mostly) the event name are fixed. The constant
+/// JSON fragments of the site's events are built and escaped once on construction, the flush only
+/// appends the event's variable data in between:
+///
+/// @code
+/// {"cat":"category",  "pid":..,"tid":..  ,"ph":"X","ts":  ..  ,"name":"event"  ,"args":...
+/// ^-- json_head() --^                    ^-- json_phase() --^ ^-- json_name() --^
+/// @endcode
+///
+/// The event name fragment is only prepared for string literals (arrays of const char), their
+/// address identifies the name on flush. Other names, e.g. pointers or names copied by
+/// TraceLog::copy, are written by the event itself.
+///
+/// The sites are function local statics, destroyed at exit before the events referring to them
+/// might be flushed. Hence the site is trivially destructible and its fragments, together with
+/// the category name, are kept in a storage never released.
+///
+/// example usage:
+/// @code{.cpp}
+/// static auto const category_proxy__ = category::get("category_name");
+/// if (category_proxy__) {
+///     static trace_site const site__{ category_proxy__, TraceEvent::phase::INSTANT, "event_name" };
+///     AddTraceEvent(site__, "event_name", TraceID::NONE, TraceEvent::flag::NONE, ...);
+/// }
+/// @endcode
+///
+class trace_site {
+public:
+    template <typename NameT>
+    trace_site(category::proxy proxy, TraceEvent::phase phase, NameT&& event_name)
+        : proxy_{ proxy }
+        , phase_{ phase }
+        , event_name_{ static_name<std::remove_reference_t<NameT>>(event_name) }
+    {
+        build();
+    }
+
+    ~trace_site() = default;
+    trace_site(trace_site const&) = delete;
+    trace_site& operator=(trace_site const&) = delete;
+    trace_site(trace_site&&) = delete;
+    trace_site& operator=(trace_site&&) = delete;
+
+public:
+    category::proxy proxy() const { return proxy_; }
+
+    std::string_view category_name() const { return category_name_; }
+
+    TraceEvent::phase phase() const { return phase_; }
+
+public:
+    /// '{"cat":"..",'
+    std::string_view json_head() const { return json.substr(0, head_sz); }
+
+    /// ',"ph":"..","ts":'
+    std::string_view json_phase() const { return json.substr(head_sz, phase_sz); }
+
+    /// ',"name":".."' if the @a event_name is the site's one, otherwise empty.
+    std::string_view json_name(char const* event_name) const
+    {
+        if (event_name != event_name_ || event_name == nullptr) {
+            return {};
+        }
+        return json.substr(head_sz + phase_sz);
+    }
+
+private:
+    /// The address of @a event_name if it's a string literal, otherwise nullptr.
+    template <typename NameT>
+    static char const* static_name(NameT const& event_name)
+    {
+        if constexpr (std::is_array_v<NameT> && std::is_same_v<std::remove_extent_t<NameT>, char const>) {
+            return event_name;
+        }
+        else {
+            return nullptr;
+        }
+    }
+
+    /// Build the JSON fragments and copy them with the category name to the static storage.
+    void build();
+
+private:
+    category::proxy const proxy_;
+    TraceEvent::phase const phase_;
+    char const* const event_name_;
+
+    std::string_view category_name_;
+    std::string_view json;  // the fragments concatenated
+    std::size_t head_sz = 0;
+    std::size_t phase_sz = 0;
+};
+
+static_assert(std::is_trivially_destructible_v<trace_site>,
+              "trace_site must outlive the static destruction, see above");
+
+}  // namespace ibis::tool::event_trace
@@ -0,0 +1,265 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <ibis/event_trace/binary_trace.hpp>
+#include <ibis/event_trace/trace_event.hpp>
+#include <ibis/event_trace/detail/binary_format.hpp>
+#include <ibis/event_trace/detail/json_writer.hpp>
+#include <ibis/event_trace/detail/trace_value.hpp>
+
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <bit>
+
+namespace ibis::tool::event_trace {
+
+namespace /* anonymous */ {
+
+namespace binary_format = detail::binary_format;
+
+/// The JSON output is written to the stream in blocks of this size.
+constexpr std::size_t OUTPUT_BLOCK_SZ = 1024 * 1024;
+
+///
+/// Reader of the binary format, see @ref binary_format, writing the events as JSON.
+///
+class binary_reader {
+public:
+    binary_reader(std::istream& in, std::ostream& out_)
+        : buf{ in.rdbuf() }
+        , os{ out_ }
+    {
+    }
+
+    void convert()
+    {
+        header();
+
+        out.append(R"({"traceEvents":[)" "\n");
+
+        for (int tag = buf->sbumpc(); tag != std::char_traits<char>::eof(); tag = buf->sbumpc()) {
+            switch (static_cast<binary_format::record>(tag)) {
+                case binary_format::record::STRING:
+                    string_record();
+                    break;
+                case binary_format::record::THREAD:
+                    process_id = signed_varint();
+                    thread_id = signed_varint();
+                    break;
+                case binary_format::record::EVENT:
+                    event_record();
+                    break;
+                case binary_format::record::END:
+                    out.append(R"(],"displayTimeUnit":"ns"})" "\n");
+                    break;
+                default:
+                    throw std::runtime_error("binary trace: unknown record tag " +
+                                             std::to_string(tag));
+            }
+
+            if (out.size() >= OUTPUT_BLOCK_SZ) {
+                write();
+            }
+        }
+
+        write();
+    }
+
+private:
+    void header()
+    {
+        std::string magic(binary_format::MAGIC.size(), '\0');
+        if (buf->sgetn(magic.data(), static_cast<std::streamsize>(magic.size())) !=
+                static_cast<std::streamsize>(magic.size()) ||
+            magic != binary_format::MAGIC) {
+            throw std::runtime_error("binary trace: invalid magic");
+        }
+        if (byte() != binary_format::VERSION) {
+            throw std::runtime_error("binary trace: unsupported version");
+        }
+    }
+
+    void string_record()
+    {
+        auto const id = varint();
+        if (id != strings.size()) {
+            throw std::runtime_error("binary trace: unexpected string ID");
+        }
+        strings.emplace_back(bytes());
+    }
+
+    void event_record()
+    {
+        auto const phase = static_cast<char>(byte());
+        auto const flags = byte();
+        auto const& category_name = string(varint());
+        auto const& event_name = string(varint());
+
+        timestamp += signed_varint();
+
+        auto json = detail::json_writer(out);
+
+        json.literal(R"({"cat":)");
+        json.string(category_name);
+        json.literal(R"(,"pid":)");
+        json.number(process_id);
+        json.literal(R"(,"tid":)");
+
+        std::int64_t duration = 0;
+        if (phase == TraceEvent::phase::COMPLETE) {
+            duration = static_cast<std::int64_t>(varint());
+        }
+        std::uint64_t trace_id = 0;
+        if ((flags & binary_format::event_flag::HAS_ID) != 0) {
+            trace_id = varint();
+        }
+        if ((flags & binary_format::event_flag::HAS_TID) != 0) {
+            json.number(signed_varint());
+        }
+        else {
+            json.number(thread_id);
+        }
+
+        json.literal(R"(,"ph":")");
+        json.literal(phase);
+        json.literal(R"(","ts":)");
+        json.number(timestamp);
+        json.literal(R"(,"name":)");
+        json.string(event_name);
+
+        if (auto const arg_count = varint(); arg_count != 0) {
+            json.literal(R"(,"args":{)");
+            for (std::size_t i = 0; i != arg_count; ++i) {
+                if (i != 0) {
+                    json.literal(',');
+                }
+                json.string(string(varint()));
+                json.literal(':');
+                value(json);
+            }
+            json.literal('}');
+        }
+
+        if (phase == TraceEvent::phase::COMPLETE) {
+            json.literal(R"(,"dur":)");
+            json.number(duration);
+        }
+
+        if ((flags & binary_format::event_flag::HAS_ID) != 0) {
+            json.literal(R"(,"id":)");
+            json.hex_string(trace_id, 8, true);
+        }
+
+        json.literal("},\n");
+    }
+
+    /// Read the typed argument value and write it as JSON, same as json_writer::value().
+    void value(detail::json_writer& json)
+    {
+        using type = trace_value::type;
+
+        switch (static_cast<type>(byte())) {
+            case type::BOOL:
+                json.literal(byte() != 0 ? "true" : "false");
+                return;
+            case type::UINT:
+                json.number(varint());
+                return;
+            case type::INT:
+                json.number(signed_varint());
+                return;
+            case type::DOUBLE: {
+                std::uint64_t bits = 0;
+                for (std::size_t i = 0; i != sizeof(bits); ++i) {  // little endian
+                    bits |= std::uint64_t{ byte() } << (8U * i);
+                }
+                json.number(std::bit_cast<double>(bits));
+                return;
+            }
+            case type::STRING:
+                json.string(bytes());
+                return;
+            case type::POINTER:
+                json.hex_string(varint());
+                return;
+            case type::NONE:
+                json.literal("null");
+                return;
+        }
+        throw std::runtime_error("binary trace: unknown value type");
+    }
+
+    std::string const& string(std::uint64_t id) const
+    {
+        if (id >= strings.size()) {
+            throw std::runtime_error("binary trace: undefined string ID");
+        }
+        return strings[id];
+    }
+
+    std::uint8_t byte()
+    {
+        auto const chr = buf->sbumpc();
+        if (chr == std::char_traits<char>::eof()) {
+            throw std::runtime_error("binary trace: truncated");
+        }
+        return static_cast<std::uint8_t>(chr);
+    }
+
+    std::uint64_t varint()
+    {
+        std::uint64_t value = 0;
+        for (std::size_t i = 0; i != binary_format::MAX_VARINT_SZ; ++i) {
+            auto const chr = byte();
+            value |= std::uint64_t{ chr & 0x7FU } << (7U * i);
+            if ((chr & 0x80U) == 0) {
+                return value;
+            }
+        }
+        throw std::runtime_error("binary trace: malformed varint");
+    }
+
+    std::int64_t signed_varint() { return binary_format::zigzag_decode(varint()); }
+
+    std::string bytes()
+    {
+        auto const size = varint();
+        std::string str(size, '\0');
+        if (buf->sgetn(str.data(), static_cast<std::streamsize>(size)) !=
+            static_cast<std::streamsize>(size)) {
+            throw std::runtime_error("binary trace: truncated");
+        }
+        return str;
+    }
+
+    void write()
+    {
+        os.write(out.data(), static_cast<std::streamsize>(out.size()));
+        out.clear();
+    }
+
+private:
+    std::streambuf* const buf;
+    std::ostream& os;
+    std::string out;
+
+    std::vector<std::string> strings;
+    std::int64_t process_id = 0;
+    std::int64_t thread_id = 0;
+    std::int64_t timestamp = 0;
+};
+
+}  // namespace
+
+void binary_to_json(std::istream& in, std::ostream& out)
+{
+    auto reader = binary_reader(in, out);
+    reader.convert();
+}
+
+}  // namespace ibis::tool::event_trace
@@ -0,0 +1,86 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <ibis/event_trace/detail/binary_writer.hpp>
+
+#include <bit>
+
+namespace ibis::tool::event_trace::detail {
+
+void binary_writer::header()
+{
+    out.append(binary_format::MAGIC);
+    byte(binary_format::VERSION);
+}
+
+void binary_writer::footer() { record(binary_format::record::END); }
+
+void binary_writer::thread(std::int64_t process_id, std::int64_t thread_id)
+{
+    if (has_thread && process_id == last_process_id && thread_id == last_thread_id) {
+        return;
+    }
+
+    record(binary_format::record::THREAD);
+    signed_varint(process_id);
+    signed_varint(thread_id);
+
+    last_process_id = process_id;
+    last_thread_id = thread_id;
+    has_thread = true;
+}
+
+void binary_writer::string_record(std::uint64_t id, std::string_view str)
+{
+    record(binary_format::record::STRING);
+    varint(id);
+    bytes(str);
+}
+
+void binary_writer::value(trace_value const& value)
+{
+    using type = trace_value::type;
+
+    auto const payload = value.data();
+    auto tag = value.type_tag();
+
+    // null strings and pointers are written as JSON's null
+    if ((tag == type::STRING && payload.str == nullptr) ||
+        (tag == type::POINTER && payload.ptr == nullptr)) {
+        tag = type::NONE;
+    }
+
+    byte(static_cast<std::uint8_t>(tag));
+
+    switch (tag) {
+        case type::BOOL:
+            byte(payload.boolean ? 1 : 0);
+            return;
+        case type::UINT:
+            varint(payload.uint);
+            return;
+        case type::INT:
+            signed_varint(payload.int_);
+            return;
+        case type::DOUBLE: {
+            auto bits = std::bit_cast<std::uint64_t>(payload.real);
+            for (std::size_t i = 0; i != sizeof(bits); ++i) {  // little endian
+                byte(static_cast<std::uint8_t>(bits & 0xFFU));
+                bits >>= 8U;
+            }
+            return;
+        }
+        case type::STRING:
+            bytes(payload.str);
+            return;
+        case type::POINTER:
+            varint(std::bit_cast<std::uintptr_t>(payload.ptr));
+            return;
+        case type::NONE:
+            return;
+    }
+}
+
+}  // namespace ibis::tool::event_trace::detail
@@ -14,6 +14,7 @@
 #include <regex>
 #include <string_view>
 #include <vector>
+#include <mutex>
 
 namespace {
 constexpr bool VERBOSE = false;
@@ -21,7 +22,9 @@ constexpr bool VERBOSE = false;
 
 namespace ibis::tool::event_trace {
 
-category::category() { my_categories.reserve(category::MAX_CATEGORIES); }
+category::category() = default;
+
+category::~category() = default;
 
 //
 // ----------------------------------------------------------------------------
@@ -31,12 +34,14 @@ category::category() { my_categories.reserve(category::MAX_CATEGORIES); }
 
 void category::set_filter(category::filter const& filter_)
 {
+    std::unique_lock lock(filter_mutex);
     category_filter_ = filter_;
     apply_filter();
 }
 
 void category::SetEnabled(std::string_view categories)
 {
+    std::unique_lock lock(filter_mutex);
     category_filter_ = filter(categories);
     apply_filter();
 }
@@ -47,7 +52,8 @@ void category::apply_filter()
         std::cout << "category: apply filter list '" << category_filter_.list_sv() << "'\n";
     }
 
-    for (auto& entry : my_categories) {
+    // the filter_mutex is held exclusively, no new categories are registered meanwhile
+    for_each([this](category::entry& entry) {
         auto const [match, enable] = category_filter_.result_of(entry.category_name());
 
         if (match) {
@@ -57,66 +63,92 @@ void category::apply_filter()
             }
             entry.enable(enable);
         }
-    }
+    });
 }
 
-category::proxy category::get_proxy(std::string_view category_name)
+category::proxy category::get_proxy(std::string_view category_name, std::uint64_t hash)
 {
-    static category::entry const categories_exhausted(
-        { std::string_view("tracing categories exhausted."), false });
-
-    std::scoped_lock scoped_lock(mutex);
-
     // Search for pre-existing category matching this name and return it ...
-    auto const end = my_categories.cend();
-    auto const iter = std::find_if(  // --
-        my_categories.cbegin(), end, [&category_name](auto const& cat_entry) {
-            return cat_entry.category_name() == category_name;
-        });
-
-    if (iter != end) {
-        return proxy(*iter);
+    auto const& bucket = buckets[hash & (BUCKET_COUNT - 1)];
+
+    if (auto const* entry = find(bucket.load(std::memory_order_acquire), category_name, hash);
+        entry != nullptr) {
+        return proxy(*entry);
     }
 
-    // ... otherwise create a new category, enable state depends on category filter
-    if (my_categories.size() < MAX_CATEGORIES) {
-        // Whether the filter matches the category name is not important here, since we are
-        // creating them here - the activation is important. This allows the filtering of the
-        // category activities even before creation at this point.
-        auto const [match, category_enabled] = category_filter_.result_of(category_name);
+    // ... otherwise create a new category, enable state depends on category filter. The filter
+    // lock is held until the entry is published, so a concurrent filter change applies to it.
+    std::shared_lock lock(filter_mutex);
 
-        if constexpr (VERBOSE) {
-            std::cout << "category: create category '" << category_name << "': "  // --
-                      << std::boolalpha << " enable: " << category_enabled << "\n";
+    // Whether the filter matches the category name is not important here, since we are
+    // creating them here - the activation is important. This allows the filtering of the
+    // category activities even before creation at this point.
+    auto const [match, category_enabled] = category_filter_.result_of(category_name);
+
+    return proxy(insert(std::make_pair(category_name, category_enabled), hash));
+}
+
+category::entry const* category::find(category::entry const* head, std::string_view name,
+                                      std::uint64_t hash)
+{
+    for (auto const* entry = head; entry != nullptr; entry = entry->next) {
+        if (entry->hash == hash && entry->category_name() == name) {
+            return entry;
         }
+    }
+    return nullptr;
+}
 
-        return my_categories.emplace_back(  // --
-            std::make_pair(category_name, category_enabled));
+category::entry const& category::insert(value_type pair, std::uint64_t hash)
+{
+    auto& bucket = buckets[hash & (BUCKET_COUNT - 1)];
+    auto* head = bucket.load(std::memory_order_acquire);
+
+    if (auto const* entry = find(head, pair.first, hash); entry != nullptr) {
+        return *entry;
+    }
+
+    auto& new_entry = entries[entries.emplace_back(pair, hash)];
+
+    if constexpr (VERBOSE) {
+        std::cout << "category: create category '" << pair.first << "': "  // --
+                  << std::boolalpha << " enable: " << pair.second << "\n";
     }
 
-    // must increase category::MAX_CATEGORIES
-    return proxy(categories_exhausted);
+    // publish the entry as new head of the bucket chain, on concurrent insertion check the
+    // entries prepended meanwhile. The entry losing the race is left unused in the storage.
+    for (;;) {
+        new_entry.next = head;
+        if (bucket.compare_exchange_weak(head, &new_entry,  // --
+                                         std::memory_order_release, std::memory_order_acquire)) {
+            category_count.fetch_add(1, std::memory_order_relaxed);
+            return new_entry;
+        }
+        if (auto const* entry = find(head, pair.first, hash); entry != nullptr) {
+            return *entry;
+        }
+    }
 }
 
 std::vector<std::string_view> category::GetKnownCategories() const
 {
     std::vector<std::string_view> categories_;
-    categories_.reserve(my_categories.size());
+    categories_.reserve(GetKnownCategoriesCount());
 
-    std::scoped_lock scoped_lock(mutex);
-
-    std::transform(my_categories.cbegin(), my_categories.cend(), std::back_inserter(categories_),
-                   [](auto const& entry) { return entry.category_name(); });
+    for_each([&categories_](auto const& entry) {  // --
+        categories_.push_back(entry.category_name());
+    });
 
     return categories_;
 }
 
 void category::append(std::initializer_list<value_type> categories)
 {
-    assert(categories.size() <= category::MAX_CATEGORIES  //--
-           && "Initializing from list exceeds capacity!");
+    std::shared_lock lock(filter_mutex);
 
-    my_categories.insert(my_categories.end(), categories.begin(), categories.end());
+    for (auto const& pair : categories) {
+        insert(pair, detail::fnv1a(pair.first));
+    }
 }
 
 // static
@@ -129,7 +161,7 @@ void category::dump(std::ostream& os)
     json.attributeBegin("category");
     json.arrayBegin();
     json.object([&]() {
-        for (auto const& cat : my_categories) {
+        for (auto const& cat : categories) {
             json.attribute(cat.category_name(), cat.enabled());
         }
     });
@@ -144,26 +176,15 @@ void category::dump(std::ostream& os)
 // category_filter
 // ----------------------------------------------------------------------------
 //
-category_filter::category_filter(std::size_t size) { regex_list.reserve(size); }
+category_filter::category_filter(std::size_t size) { pattern_list.reserve(size); }
 
-category_filter::category_filter(std::string_view category_regex, std::size_t size)
-    : categories(category_regex)
+category_filter::category_filter(std::string_view category_list, std::size_t size)
+    : categories(category_list)
 {
     using namespace ibis::util;
+    using namespace std::literals;
 
-    regex_list.reserve(size);
-
-    // helper to create regex objects
-    auto const regex = [](std::string_view pattern) {
-        switch (pattern.front()) {
-            case '-':  // to disable 'marker'
-                [[fallthrough]];
-            case '+':  // convenience, even if redundant to enable
-                pattern.remove_prefix(1);
-            default:;  // nothing
-        }
-        return std::regex(pattern.begin(), pattern.end(), std::regex_constants::ECMAScript);
-    };
+    pattern_list.reserve(size);
 
     // Tokenize list of categories, delimited by ','.
     static constexpr char delimiter = ',';
@@ -173,45 +194,74 @@ category_filter::category_filter(std::string_view category_regex, std::size_t si
     // Maybe wait for C++20, see [split_view](https://en.cppreference.com/w/cpp/ranges/split_view)
     // ```std::ranges::for_each(hello | std::ranges::views::split(' '), print);```
     // where print is a lambda. Even ranges-v3 has for_each, but seems to have different syntax!
-    while ((start = category_regex.find_first_not_of(delimiter, end)) != std::string_view::npos) {
-        end = category_regex.find(delimiter, start);
-        auto const pattern = trim(category_regex.substr(start, end - start));
+    while ((start = category_list.find_first_not_of(delimiter, end)) != std::string_view::npos) {
+        end = category_list.find(delimiter, start);
+        auto const pattern_sv = trim(category_list.substr(start, end - start));
+
+        if (pattern_sv.empty()) {
+            continue;
+        }
+
+        auto expr = pattern_sv;
+        bool enable = true;
+
+        switch (expr.front()) {
+            case '-':  // to disable 'marker'
+                enable = false;
+                [[fallthrough]];
+            case '+':  // convenience, even if redundant to enable
+                expr.remove_prefix(1);
+            default:;  // nothing
+        }
 
-        try {
-            regex_list.emplace_back(pattern, regex(pattern));
+        if (expr.starts_with("re:"sv)) {
+            expr.remove_prefix(3);
+            try {
+                pattern_list.push_back(  // --
+                    { pattern_sv, enable,
+                      std::regex(expr.begin(), expr.end(), std::regex_constants::ECMAScript) });
+            }
+            catch (std::regex_error const& e) {
+                std::cerr << "category filter regex '" << pattern_sv << "' error caught: "  // --
+                          << e.what() << '\n';
+                // FixMe: Maybe rethrow??
+            }
         }
-        catch (std::regex_error const& e) {
-            std::cerr << "category filter regex '" << pattern << "' error caught: "  // --
-                      << e.what() << '\n';
-            regex_list.pop_back();
-            // FixMe: Maybe rethrow??
+        else {
+            pattern_list.push_back({ pattern_sv, enable, detail::glob_matcher(expr) });
         }
     }
 }
 
+bool category_filter::pattern::operator()(std::string_view category_name) const
+{
+    if (auto const* regex = std::get_if<std::regex>(&matcher); regex != nullptr) {
+        return std::regex_search(category_name.begin(), category_name.end(), *regex);
+    }
+    return std::get<detail::glob_matcher>(matcher)(category_name);
+}
+
 std::pair<bool, bool> category_filter::result_of(std::string_view category_name) const
 {
-    // default behavior on empty filter RE
+    // default behavior on empty filter list
     bool match = false;
     bool enable = true;
 
-    if (regex_list.empty()) {
+    if (pattern_list.empty()) {
         if constexpr (VERBOSE) {
-            std::cout << "  RE empty filter pattern applied on category '"  // --
+            std::cout << "  empty filter pattern applied on category '"  // --
                       << category_name << "' (" << std::boolalpha << "enable: " << enable << ")\n";
         }
         return { match, enable };
     }
 
-    for (auto const& [regex_sv, regex] : regex_list) {
-        match = std::regex_search(category_name.begin(), category_name.end(), regex);
+    for (auto const& pattern : pattern_list) {
+        match = pattern(category_name);
         if (match) {
             // check to disable category
-            if (regex_sv.front() == '-') {
-                enable = false;
-            }
+            enable = pattern.enable;
             if constexpr (VERBOSE) {
-                std::cout << "  RE filter pattern '" << regex_sv << "' matches on category '"
+                std::cout << "  filter pattern '" << pattern.pattern_sv << "' matches on category '"
                           << category_name << "' " << std::boolalpha  //--
                           << "(enable: " << enable << ")\n";
             }
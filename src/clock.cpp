@@ -0,0 +1,85 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <ibis/event_trace/detail/clock.hpp>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+#include <array>
+
+namespace ibis::tool::event_trace::clock {
+
+namespace /* anonymous */ {
+
+/// Duration of the calibration, the longer the more accurate the TSC's rate.
+constexpr auto CALIBRATION_TIME = std::chrono::milliseconds(10);
+
+/// Check the CPUID's "Advanced Power Management" leaf 0x80000007 for invariant TSC, EDX bit 8.
+bool has_invariant_tsc()
+{
+    constexpr unsigned LEAF = 0x80000007;
+    constexpr unsigned INVARIANT_TSC_BIT = 1U << 8U;
+
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned eax = 0;
+    unsigned ebx = 0;
+    unsigned ecx = 0;
+    unsigned edx = 0;
+    if (__get_cpuid(LEAF, &eax, &ebx, &ecx, &edx) == 0) {  // leaf not supported
+        return false;
+    }
+    return (edx & INVARIANT_TSC_BIT) != 0;
+#elif defined(_M_X64) || defined(_M_IX86)
+    std::array<int, 4> regs = {};  // EAX, EBX, ECX, EDX
+    __cpuid(regs.data(), static_cast<int>(0x80000000));
+    if (static_cast<unsigned>(regs[0]) < LEAF) {
+        return false;
+    }
+    __cpuid(regs.data(), static_cast<int>(LEAF));
+    return (static_cast<unsigned>(regs[3]) & INVARIANT_TSC_BIT) != 0;
+#else
+    return false;
+#endif
+}
+
+}  // namespace
+
+tsc_clock::calibration_type tsc_clock::calibrate() noexcept
+{
+    calibration_type calib;
+
+    if (!has_invariant_tsc()) {
+        return calib;  // fall back to steady_clock
+    }
+
+    // Busy wait for the calibration time, sleeping would only add the scheduler's latency. The
+    // TSC is read close to the steady clock on both ends, so their mutual offset cancels out.
+    auto const time_begin = clock_type::now();
+    auto const ticks_begin = read_tsc();
+
+    auto time_end = time_begin;
+    while (time_end - time_begin < CALIBRATION_TIME) {
+        time_end = clock_type::now();
+    }
+    auto const ticks_end = read_tsc();
+
+    auto const elapsed_ns = static_cast<double>((time_end - time_begin).count());
+    auto const elapsed_ticks = static_cast<double>(ticks_end - ticks_begin);
+
+    if (ticks_end <= ticks_begin || elapsed_ns <= 0) {
+        return calib;  // something odd, e.g. virtualized TSC, don't trust it
+    }
+
+    calib.use_tsc = true;
+    calib.base_ticks = ticks_begin;
+    calib.base_time = time_begin;
+    calib.ns_per_tick = elapsed_ns / elapsed_ticks;
+
+    return calib;
+}
+
+}  // namespace ibis::tool::event_trace::clock
@@ -0,0 +1,194 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <ibis/event_trace/detail/glob_matcher.hpp>
+
+#include <cassert>
+
+namespace ibis::tool::event_trace::detail {
+
+glob_matcher::glob_matcher(std::string_view pattern)
+{
+    bool anchor_begin = false;
+    bool anchor_end = false;
+
+    if (!pattern.empty() && pattern.front() == '^') {
+        anchor_begin = true;
+        pattern.remove_prefix(1);
+    }
+    // an escaped '$' is a literal
+    if (!pattern.empty() && pattern.back() == '$' &&
+        !(pattern.size() >= 2 && pattern[pattern.size() - 2] == '\\')) {
+        anchor_end = true;
+        pattern.remove_suffix(1);
+    }
+
+    bool has_wildcard = false;
+
+    auto const add_char = [this](char chr) {
+        elements.push_back({ element::type::CHAR, chr, 0 });
+        literal.push_back(chr);
+    };
+
+    // not anchored patterns match anywhere, like a leading and trailing '*'
+    if (!anchor_begin) {
+        elements.push_back({ element::type::ANY_STRING, '\0', 0 });
+    }
+
+    for (std::size_t pos = 0; pos < pattern.size(); ++pos) {
+        char const chr = pattern[pos];
+
+        switch (chr) {
+            case '\\':
+                if (pos + 1 < pattern.size()) {
+                    ++pos;
+                }
+                add_char(pattern[pos]);
+                break;
+            case '*':
+                has_wildcard = true;
+                if (elements.empty() || elements.back().type_ != element::type::ANY_STRING) {
+                    elements.push_back({ element::type::ANY_STRING, '\0', 0 });
+                }
+                break;
+            case '?':
+                has_wildcard = true;
+                elements.push_back({ element::type::ANY_CHAR, '\0', 0 });
+                break;
+            case '[': {
+                auto const close = pattern.find(']', pos + 2);  // "[]...]" includes ']'
+                if (close == std::string_view::npos) {
+                    add_char(chr);  // not a set, take it literally
+                    break;
+                }
+                has_wildcard = true;
+
+                auto set_sv = pattern.substr(pos + 1, close - pos - 1);
+                bool const negate =
+                    set_sv.size() > 1 && (set_sv.front() == '!' || set_sv.front() == '^');
+                if (negate) {
+                    set_sv.remove_prefix(1);
+                }
+
+                char_set set;
+                for (std::size_t i = 0; i < set_sv.size(); ++i) {
+                    auto const first = static_cast<unsigned char>(set_sv[i]);
+                    if (i + 2 < set_sv.size() && set_sv[i + 1] == '-') {
+                        auto const last = static_cast<unsigned char>(set_sv[i + 2]);
+                        for (unsigned c = first; c <= last; ++c) {
+                            set.set(c);
+                        }
+                        i += 2;
+                    }
+                    else {
+                        set.set(first);
+                    }
+                }
+                if (negate) {
+                    set.flip();
+                }
+
+                char_sets.push_back(set);
+                elements.push_back({ element::type::CHAR_SET, '\0',
+                                     static_cast<std::uint16_t>(char_sets.size() - 1) });
+                pos = close;
+                break;
+            }
+            default:
+                add_char(chr);
+        }
+    }
+
+    if (!anchor_end &&
+        (elements.empty() || elements.back().type_ != element::type::ANY_STRING)) {
+        elements.push_back({ element::type::ANY_STRING, '\0', 0 });
+    }
+
+    if (has_wildcard) {
+        kind_ = kind::WILDCARD;
+        literal.clear();
+        return;
+    }
+
+    // plain string, use the faster string compare
+    elements.clear();
+    if (anchor_begin) {
+        kind_ = anchor_end ? kind::EXACT : kind::PREFIX;
+    }
+    else {
+        kind_ = anchor_end ? kind::SUFFIX : kind::SUBSTRING;
+    }
+}
+
+bool glob_matcher::operator()(std::string_view name) const
+{
+    switch (kind_) {
+        case kind::EXACT:
+            return name == literal;
+        case kind::PREFIX:
+            return name.starts_with(literal);
+        case kind::SUFFIX:
+            return name.ends_with(literal);
+        case kind::SUBSTRING:
+            return name.find(literal) != std::string_view::npos;
+        case kind::WILDCARD:
+            return match_wildcard(name);
+    }
+    return false;
+}
+
+bool glob_matcher::matches(element const& elem, char chr) const
+{
+    switch (elem.type_) {
+        case element::type::CHAR:
+            return elem.chr == chr;
+        case element::type::ANY_CHAR:
+            return true;
+        case element::type::CHAR_SET:
+            return char_sets[elem.index].test(static_cast<unsigned char>(chr));
+        case element::type::ANY_STRING:
+            break;
+    }
+    assert(false && "ANY_STRING is handled by the caller");
+    return false;
+}
+
+bool glob_matcher::match_wildcard(std::string_view name) const
+{
+    // Iterative wildcard matching: on mismatch resume after the last '*' seen, which consumes
+    // one more character of the name. Since a later '*' can cover everything an earlier one
+    // can, only the last '*' needs to be remembered.
+    std::size_t const count = elements.size();
+    std::size_t elem_pos = 0;
+    std::size_t name_pos = 0;
+    std::size_t star_pos = count;  // none
+    std::size_t star_name_pos = 0;
+
+    while (name_pos < name.size()) {
+        if (elem_pos < count && elements[elem_pos].type_ == element::type::ANY_STRING) {
+            star_pos = elem_pos++;
+            star_name_pos = name_pos;
+        }
+        else if (elem_pos < count && matches(elements[elem_pos], name[name_pos])) {
+            ++elem_pos;
+            ++name_pos;
+        }
+        else if (star_pos != count) {
+            elem_pos = star_pos + 1;
+            name_pos = ++star_name_pos;
+        }
+        else {
+            return false;
+        }
+    }
+
+    while (elem_pos < count && elements[elem_pos].type_ == element::type::ANY_STRING) {
+        ++elem_pos;
+    }
+
+    return elem_pos == count;
+}
+
+}  // namespace ibis::tool::event_trace::detail
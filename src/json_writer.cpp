@@ -0,0 +1,188 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <ibis/event_trace/detail/json_writer.hpp>
+
+#include <bit>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IBIS_JSON_WRITER_SSE2
+#include <immintrin.h>
+#endif
+
+namespace ibis::tool::event_trace::detail {
+
+namespace /* anonymous */ {
+
+constexpr std::string_view HEX_LOWER = "0123456789abcdef";
+constexpr std::string_view HEX_UPPER = "0123456789ABCDEF";
+
+/// Characters to be escaped by JSON, these are '"', '\\' and the control characters.
+constexpr bool needs_escape(char chr)
+{
+    auto const uchr = static_cast<unsigned char>(chr);
+    return uchr < 0x20 || chr == '"' || chr == '\\';
+}
+
+#if defined(__AVX2__)
+/// Bit mask of the 32 characters at @a ptr to be escaped.
+inline std::uint32_t escape_mask_32(char const* ptr)
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    __m256i const chars = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(ptr));
+    // unsigned chr <= 0x1F, there is no unsigned compare
+    __m256i const control = _mm256_cmpeq_epi8(_mm256_min_epu8(chars, _mm256_set1_epi8(0x1F)), chars);
+    __m256i const quote = _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('"'));
+    __m256i const backslash = _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('\\'));
+    return static_cast<std::uint32_t>(
+        _mm256_movemask_epi8(_mm256_or_si256(control, _mm256_or_si256(quote, backslash))));
+}
+#endif
+
+#if defined(IBIS_JSON_WRITER_SSE2)
+/// Bit mask of the 16 characters at @a ptr to be escaped.
+inline std::uint32_t escape_mask_16(char const* ptr)
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    __m128i const chars = _mm_loadu_si128(reinterpret_cast<__m128i const*>(ptr));
+    // unsigned chr <= 0x1F, there is no unsigned compare
+    __m128i const control = _mm_cmpeq_epi8(_mm_min_epu8(chars, _mm_set1_epi8(0x1F)), chars);
+    __m128i const quote = _mm_cmpeq_epi8(chars, _mm_set1_epi8('"'));
+    __m128i const backslash = _mm_cmpeq_epi8(chars, _mm_set1_epi8('\\'));
+    return static_cast<std::uint32_t>(
+        _mm_movemask_epi8(_mm_or_si128(control, _mm_or_si128(quote, backslash))));
+}
+#endif
+
+}  // namespace
+
+void json_writer::number(double value)
+{
+    if (!std::isfinite(value)) {
+        out.append("null");
+        return;
+    }
+
+    std::array<char, 32> buf;  // shortest round trip of double requires max. 24 chars
+    auto const result = std::to_chars(buf.data(), buf.data() + buf.size(), value);
+    out.append(buf.data(), result.ptr);
+}
+
+void json_writer::hex_string(std::uint64_t value, std::size_t min_digits, bool upper_case)
+{
+    auto const digits = upper_case ? HEX_UPPER : HEX_LOWER;
+
+    std::array<char, 16> buf;
+    auto* const end = buf.data() + buf.size();
+    auto* ptr = end;
+    do {
+        *--ptr = digits[value & 0xFU];
+        value >>= 4U;
+    } while (value != 0);
+
+    out.append(R"("0x)");
+    for (auto count = static_cast<std::size_t>(end - ptr); count < min_digits; ++count) {
+        out.push_back('0');
+    }
+    out.append(ptr, end);
+    out.push_back('"');
+}
+
+/// Scans 32 (AVX2) or 16 (SSE2) characters at once, the remainder character wise.
+std::size_t json_writer::find_escape(std::string_view str, std::size_t pos)
+{
+    [[maybe_unused]] char const* const data = str.data();
+    [[maybe_unused]] std::size_t const size = str.size();
+
+#if defined(__AVX2__)
+    for (; pos + 32 <= size; pos += 32) {
+        if (auto const mask = escape_mask_32(data + pos); mask != 0) {
+            return pos + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+    }
+#endif
+#if defined(IBIS_JSON_WRITER_SSE2)
+    for (; pos + 16 <= size; pos += 16) {
+        if (auto const mask = escape_mask_16(data + pos); mask != 0) {
+            return pos + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+    }
+#endif
+
+    for (; pos != str.size(); ++pos) {
+        if (needs_escape(str[pos])) {
+            return pos;
+        }
+    }
+    return pos;
+}
+
+std::string_view json_writer::escape_sequence(char chr, std::array<char, 6>& buf)
+{
+    // clang-format off
+    switch (chr) {
+        case '"':  return R"(\")";
+        case '\\': return R"(\\)";
+        case '\b': return R"(\b)";
+        case '\f': return R"(\f)";
+        case '\n': return R"(\n)";
+        case '\r': return R"(\r)";
+        case '\t': return R"(\t)";
+        default: {  // other control characters as UNICODE
+            auto const uchr = static_cast<unsigned char>(chr);
+            buf = { '\\', 'u', '0', '0', HEX_UPPER[uchr >> 4U], HEX_UPPER[uchr & 0xFU] };
+            return { buf.data(), buf.size() };
+        }
+    }
+    // clang-format on
+}
+
+void json_writer::escaped(std::string_view str)
+{
+    // Copy runs of characters not to be escaped at once, most strings don't need escaping at all.
+    escape(str, [this](std::string_view run) { out.append(run); });
+}
+
+void json_writer::value(trace_value const& value)
+{
+    using type = trace_value::type;
+
+    auto const payload = value.data();
+
+    switch (value.type_tag()) {
+        case type::BOOL:
+            literal(payload.boolean ? "true" : "false");
+            return;
+        case type::UINT:
+            number(payload.uint);
+            return;
+        case type::INT:
+            number(payload.int_);
+            return;
+        case type::DOUBLE:
+            number(payload.real);
+            return;
+        case type::STRING:
+            if (payload.str == nullptr) {
+                break;
+            }
+            string(payload.str);
+            return;
+        case type::POINTER:
+            if (payload.ptr == nullptr) {
+                break;
+            }
+            // JSON only supports double and 64-bit integers numbers. So output as a hex string.
+            hex_string(std::bit_cast<std::uintptr_t>(payload.ptr));
+            return;
+        case type::NONE:
+            break;
+    }
+
+    literal("null");
+}
+
+}  // namespace ibis::tool::event_trace::detail
@@ -0,0 +1,449 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <ibis/event_trace/detail/perfetto_writer.hpp>
+#include <ibis/event_trace/detail/fnv1a.hpp>
+
+#include <bit>
+#include <string>
+
+namespace ibis::tool::event_trace::detail {
+
+namespace /* anonymous */ {
+
+// Field numbers and enums of Perfetto's protos used, see
+// https://github.com/google/perfetto/tree/master/protos/perfetto/trace
+
+namespace trace {
+constexpr std::uint32_t PACKET = 1;
+}
+
+namespace trace_packet {
+constexpr std::uint32_t TIMESTAMP = 8;
+constexpr std::uint32_t TRUSTED_PACKET_SEQUENCE_ID = 10;
+constexpr std::uint32_t TRACK_EVENT = 11;
+constexpr std::uint32_t INTERNED_DATA = 12;
+constexpr std::uint32_t SEQUENCE_FLAGS = 13;
+constexpr std::uint32_t TRACK_DESCRIPTOR = 60;
+
+constexpr std::uint32_t SEQ_INCREMENTAL_STATE_CLEARED = 1;
+constexpr std::uint32_t SEQ_NEEDS_INCREMENTAL_STATE = 2;
+}  // namespace trace_packet
+
+namespace track_event {
+constexpr std::uint32_t CATEGORY_IIDS = 3;
+constexpr std::uint32_t DEBUG_ANNOTATIONS = 4;
+constexpr std::uint32_t TYPE = 9;
+constexpr std::uint32_t NAME_IID = 10;
+constexpr std::uint32_t TRACK_UUID = 11;
+constexpr std::uint32_t COUNTER_VALUE = 30;
+constexpr std::uint32_t DOUBLE_COUNTER_VALUE = 44;
+
+constexpr std::uint32_t TYPE_SLICE_BEGIN = 1;
+constexpr std::uint32_t TYPE_SLICE_END = 2;
+constexpr std::uint32_t TYPE_INSTANT = 3;
+constexpr std::uint32_t TYPE_COUNTER = 4;
+}  // namespace track_event
+
+namespace debug_annotation {
+constexpr std::uint32_t NAME_IID = 1;
+constexpr std::uint32_t BOOL_VALUE = 2;
+constexpr std::uint32_t UINT_VALUE = 3;
+constexpr std::uint32_t INT_VALUE = 4;
+constexpr std::uint32_t DOUBLE_VALUE = 5;
+constexpr std::uint32_t STRING_VALUE = 6;
+constexpr std::uint32_t POINTER_VALUE = 7;
+}  // namespace debug_annotation
+
+namespace interned_data {
+constexpr std::uint32_t EVENT_CATEGORIES = 1;
+constexpr std::uint32_t EVENT_NAMES = 2;
+constexpr std::uint32_t DEBUG_ANNOTATION_NAMES = 3;
+
+// the fields of EventCategory, EventName and DebugAnnotationName
+constexpr std::uint32_t IID = 1;
+constexpr std::uint32_t NAME = 2;
+}  // namespace interned_data
+
+namespace track_descriptor {
+constexpr std::uint32_t UUID = 1;
+constexpr std::uint32_t NAME = 2;
+constexpr std::uint32_t PROCESS = 3;
+constexpr std::uint32_t THREAD = 4;
+constexpr std::uint32_t PARENT_UUID = 5;
+constexpr std::uint32_t COUNTER = 8;
+}  // namespace track_descriptor
+
+namespace process_descriptor {
+constexpr std::uint32_t PID = 1;
+}
+
+namespace thread_descriptor {
+constexpr std::uint32_t PID = 1;
+constexpr std::uint32_t TID = 2;
+constexpr std::uint32_t THREAD_NAME = 5;
+}  // namespace thread_descriptor
+
+/// All packets are written on the same sequence, required to resolve the interned data.
+constexpr std::uint64_t SEQUENCE_ID = 1;
+
+/// The size of nested messages is written as 4 byte varint, patched after the message is written
+/// (as Perfetto's protozero does). Hence the messages are limited to 256 MiB.
+constexpr std::size_t MESSAGE_SIZE_SZ = 4;
+
+/// Kind of the tracks, part of the track's UUID.
+enum class track_kind : std::uint8_t { PROCESS = 1, THREAD, ASYNC, COUNTER };
+
+/// The UUID of the track of @a kind, @a id and @a name.
+std::uint64_t track_uuid(track_kind kind, std::int64_t process_id, std::uint64_t id,
+                         std::string_view name = {})
+{
+    std::string key;
+    key.reserve(2 * sizeof(std::uint64_t) + 1 + name.size());
+    key.push_back(static_cast<char>(kind));
+    for (auto value : { static_cast<std::uint64_t>(process_id), id }) {
+        for (std::size_t i = 0; i != sizeof(value); ++i) {
+            key.push_back(static_cast<char>(value & 0xFFU));
+            value >>= 8U;
+        }
+    }
+    key.append(name);
+    return fnv1a(key);
+}
+
+}  // namespace
+
+void perfetto_writer::header(std::int64_t process_id_)
+{
+    auto const packet = begin_packet(-1, trace_packet::SEQ_INCREMENTAL_STATE_CLEARED);
+    end_message(packet);
+
+    process_track(process_id_);
+}
+
+void perfetto_writer::thread(std::int64_t process_id_, std::int64_t thread_id_)
+{
+    if (thread_track_uuid != 0 && process_id_ == process_id && thread_id_ == thread_id) {
+        return;
+    }
+
+    process_id = process_id_;
+    thread_id = thread_id_;
+    thread_track_uuid =
+        track_uuid(track_kind::THREAD, process_id, static_cast<std::uint64_t>(thread_id));
+
+    auto const parent_uuid = process_track(process_id);
+    track_descriptor(thread_track_uuid, [&]() {
+        varint_field(track_descriptor::PARENT_UUID, parent_uuid);
+        auto const thread = begin_message(track_descriptor::THREAD);
+        int_field(thread_descriptor::PID, process_id);
+        int_field(thread_descriptor::TID, thread_id);
+        end_message(thread);
+    });
+}
+
+void perfetto_writer::thread_name(std::int64_t process_id_, std::int64_t thread_id_,
+                                  std::string_view name)
+{
+    auto const uuid =
+        track_uuid(track_kind::THREAD, process_id_, static_cast<std::uint64_t>(thread_id_));
+    auto const parent_uuid = process_track(process_id_);
+
+    // described again, also if known already
+    tracks.insert(uuid);
+
+    auto const packet = begin_packet(-1, 0);
+    auto const descriptor = begin_message(trace_packet::TRACK_DESCRIPTOR);
+    varint_field(track_descriptor::UUID, uuid);
+    varint_field(track_descriptor::PARENT_UUID, parent_uuid);
+    auto const thread = begin_message(track_descriptor::THREAD);
+    int_field(thread_descriptor::PID, process_id_);
+    int_field(thread_descriptor::TID, thread_id_);
+    string_field(thread_descriptor::THREAD_NAME, name);
+    end_message(thread);
+    end_message(descriptor);
+    end_message(packet);
+}
+
+void perfetto_writer::track_event(event const& event)
+{
+    switch (event.phase) {
+        case 'B':
+            slice_event(event, thread_track_uuid, track_event::TYPE_SLICE_BEGIN, event.timestamp,
+                        true);
+            return;
+        case 'E':
+            slice_event(event, thread_track_uuid, track_event::TYPE_SLICE_END, event.timestamp,
+                        true);
+            return;
+        case 'X':
+            slice_event(event, thread_track_uuid, track_event::TYPE_SLICE_BEGIN, event.timestamp,
+                        true);
+            slice_event(event, thread_track_uuid, track_event::TYPE_SLICE_END,
+                        event.timestamp + event.duration, false);
+            return;
+        case 'S':
+            slice_event(event, async_track(event), track_event::TYPE_SLICE_BEGIN,
+                        event.timestamp, true);
+            return;
+        case 'T':
+            slice_event(event, async_track(event), track_event::TYPE_INSTANT, event.timestamp,
+                        true);
+            return;
+        case 'F':
+            slice_event(event, async_track(event), track_event::TYPE_SLICE_END, event.timestamp,
+                        true);
+            return;
+        case 'C':
+            counter_event(event);
+            return;
+        default:  // 'I' and unknown phases
+            slice_event(event, thread_track_uuid, track_event::TYPE_INSTANT, event.timestamp,
+                        true);
+            return;
+    }
+}
+
+void perfetto_writer::double_field(std::uint32_t field, double value)
+{
+    tag(field, FIXED64);
+    auto bits = std::bit_cast<std::uint64_t>(value);
+    for (std::size_t i = 0; i != sizeof(bits); ++i) {  // little endian
+        out.push_back(static_cast<char>(bits & 0xFFU));
+        bits >>= 8U;
+    }
+}
+
+std::size_t perfetto_writer::begin_message(std::uint32_t field)
+{
+    tag(field, LENGTH_DELIMITED);
+    auto const position = out.size();
+    out.append(MESSAGE_SIZE_SZ, '\0');
+    return position;
+}
+
+void perfetto_writer::end_message(std::size_t position)
+{
+    auto size = out.size() - position - MESSAGE_SIZE_SZ;
+    for (std::size_t i = 0; i != MESSAGE_SIZE_SZ; ++i) {
+        auto const continuation = (i + 1 != MESSAGE_SIZE_SZ) ? 0x80U : 0U;
+        out[position + i] = static_cast<char>((size & 0x7FU) | continuation);
+        size >>= 7U;
+    }
+}
+
+std::size_t perfetto_writer::begin_packet(std::int64_t timestamp, std::uint32_t sequence_flags)
+{
+    auto const packet = begin_message(trace::PACKET);
+    if (timestamp >= 0) {
+        varint_field(trace_packet::TIMESTAMP, static_cast<std::uint64_t>(timestamp));
+    }
+    varint_field(trace_packet::TRUSTED_PACKET_SEQUENCE_ID, SEQUENCE_ID);
+    if (sequence_flags != 0) {
+        varint_field(trace_packet::SEQUENCE_FLAGS, sequence_flags);
+    }
+    return packet;
+}
+
+void perfetto_writer::interned_data()
+{
+    if (new_strings.empty()) {
+        return;
+    }
+
+    auto const interned = begin_message(trace_packet::INTERNED_DATA);
+    for (auto const& entry : new_strings) {
+        auto const message = begin_message(entry.field);
+        varint_field(interned_data::IID, entry.iid);
+        string_field(interned_data::NAME, entry.str);
+        end_message(message);
+    }
+    end_message(interned);
+
+    new_strings.clear();
+}
+
+template <typename DescribeT>
+void perfetto_writer::track_descriptor(std::uint64_t uuid, DescribeT&& describe)
+{
+    if (!tracks.insert(uuid).second) {
+        return;  // described already
+    }
+
+    auto const packet = begin_packet(-1, 0);
+    auto const descriptor = begin_message(trace_packet::TRACK_DESCRIPTOR);
+    varint_field(track_descriptor::UUID, uuid);
+    describe();
+    end_message(descriptor);
+    end_message(packet);
+}
+
+void perfetto_writer::slice_event(event const& event, std::uint64_t track_uuid_,
+                                  std::uint32_t type, std::int64_t timestamp, bool with_args)
+{
+    auto const intern = [this](string_table& table, std::uint32_t field, std::string_view str) {
+        auto const [iid, inserted] = table.insert(str);
+        if (inserted) {
+            new_strings.push_back(new_string{ field, iid, str });
+        }
+        return iid;
+    };
+
+    // the interned data precede the track event within the packet
+    auto const category_iid =
+        intern(categories, interned_data::EVENT_CATEGORIES, event.category_name);
+    auto const name_iid = intern(event_names, interned_data::EVENT_NAMES, event.event_name);
+
+    arg_iids.clear();
+    if (with_args) {
+        for (auto const& [arg_name, value] : event.args) {
+            arg_iids.push_back(intern(annotation_names, interned_data::DEBUG_ANNOTATION_NAMES,
+                                      arg_name));
+        }
+    }
+
+    auto const packet = begin_packet(timestamp, trace_packet::SEQ_NEEDS_INCREMENTAL_STATE);
+    interned_data();
+
+    auto const track_event = begin_message(trace_packet::TRACK_EVENT);
+    varint_field(track_event::CATEGORY_IIDS, category_iid);
+    varint_field(track_event::TYPE, type);
+    if (type != track_event::TYPE_SLICE_END) {
+        varint_field(track_event::NAME_IID, name_iid);
+    }
+    varint_field(track_event::TRACK_UUID, track_uuid_);
+
+    for (std::size_t i = 0; i != arg_iids.size(); ++i) {
+        using value_type = trace_value::type;
+
+        auto const& value = event.args[i].second;
+        auto const payload = value.data();
+
+        auto const annotation_value = [&]() {
+            switch (value.type_tag()) {
+                case value_type::BOOL:
+                    varint_field(debug_annotation::BOOL_VALUE, payload.boolean ? 1 : 0);
+                    return;
+                case value_type::UINT:
+                    varint_field(debug_annotation::UINT_VALUE, payload.uint);
+                    return;
+                case value_type::INT:
+                    int_field(debug_annotation::INT_VALUE, payload.int_);
+                    return;
+                case value_type::DOUBLE:
+                    double_field(debug_annotation::DOUBLE_VALUE, payload.real);
+                    return;
+                case value_type::STRING:
+                    string_field(debug_annotation::STRING_VALUE, payload.str);
+                    return;
+                case value_type::POINTER:
+                    varint_field(debug_annotation::POINTER_VALUE,
+                                 std::bit_cast<std::uintptr_t>(payload.ptr));
+                    return;
+                case value_type::NONE:
+                    return;
+            }
+        };
+
+        if (value.type_tag() == value_type::NONE ||
+            (value.type_tag() == value_type::STRING && payload.str == nullptr) ||
+            (value.type_tag() == value_type::POINTER && payload.ptr == nullptr)) {
+            continue;  // no value
+        }
+
+        auto const annotation = begin_message(track_event::DEBUG_ANNOTATIONS);
+        varint_field(debug_annotation::NAME_IID, arg_iids[i]);
+        annotation_value();
+        end_message(annotation);
+    }
+
+    end_message(track_event);
+    end_message(packet);
+}
+
+void perfetto_writer::counter_event(event const& event)
+{
+    using value_type = trace_value::type;
+
+    auto const parent_uuid = process_track(process_id);
+
+    for (auto const& [arg_name, value] : event.args) {
+        auto const type = value.type_tag();
+        if (type != value_type::BOOL && type != value_type::UINT && type != value_type::INT &&
+            type != value_type::DOUBLE) {
+            continue;  // not a number
+        }
+
+        // the counter's series is named by the event name, ID and the argument name
+        auto name = std::string(event.event_name);
+        if (event.has_id) {
+            name += '[' + std::to_string(event.trace_id) + ']';
+        }
+        name += ' ';
+        name += arg_name;
+
+        auto const uuid = track_uuid(track_kind::COUNTER, process_id,
+                                     event.has_id ? event.trace_id : 0, name);
+        track_descriptor(uuid, [&]() {
+            varint_field(track_descriptor::PARENT_UUID, parent_uuid);
+            string_field(track_descriptor::NAME, name);
+            auto const counter = begin_message(track_descriptor::COUNTER);
+            end_message(counter);
+        });
+
+        auto const packet = begin_packet(event.timestamp, 0);
+        auto const track_event = begin_message(trace_packet::TRACK_EVENT);
+        varint_field(track_event::TYPE, track_event::TYPE_COUNTER);
+        varint_field(track_event::TRACK_UUID, uuid);
+
+        auto const payload = value.data();
+        switch (type) {
+            case value_type::BOOL:
+                int_field(track_event::COUNTER_VALUE, payload.boolean ? 1 : 0);
+                break;
+            case value_type::UINT:
+                int_field(track_event::COUNTER_VALUE, static_cast<std::int64_t>(payload.uint));
+                break;
+            case value_type::INT:
+                int_field(track_event::COUNTER_VALUE, payload.int_);
+                break;
+            default:
+                double_field(track_event::DOUBLE_COUNTER_VALUE, payload.real);
+                break;
+        }
+
+        end_message(track_event);
+        end_message(packet);
+    }
+}
+
+std::uint64_t perfetto_writer::process_track(std::int64_t process_id_)
+{
+    auto const uuid = track_uuid(track_kind::PROCESS, process_id_, 0);
+    track_descriptor(uuid, [&]() {
+        auto const process = begin_message(track_descriptor::PROCESS);
+        int_field(process_descriptor::PID, process_id_);
+        end_message(process);
+    });
+    return uuid;
+}
+
+std::uint64_t perfetto_writer::async_track(event const& event)
+{
+    // Chrome groups the async events by category, name and ID
+    auto name = std::string(event.category_name);
+    name += '\0';
+    name += event.event_name;
+
+    auto const uuid = track_uuid(track_kind::ASYNC, process_id, event.trace_id, name);
+    auto const parent_uuid = process_track(process_id);
+    track_descriptor(uuid, [&]() {
+        varint_field(track_descriptor::PARENT_UUID, parent_uuid);
+        string_field(track_descriptor::NAME, event.event_name);
+    });
+    return uuid;
+}
+
+}  // namespace ibis::tool::event_trace::detail
@@ -0,0 +1,96 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <ibis/event_trace/detail/string_pool.hpp>
+
+#include <functional>
+#include <cstring>
+
+namespace ibis::tool::event_trace::detail {
+
+namespace /* anonymous */ {
+
+/// Source of the pool's session IDs, 0 is never used to mark empty cache entries.
+std::atomic<std::uint64_t> session_counter = 0;
+
+///
+/// Direct mapped cache of the recently interned strings of the calling thread.
+///
+struct front_cache {
+    static constexpr std::size_t CACHE_SZ = 64;  // must be power of 2
+
+    struct entry {
+        std::uint64_t session_id = 0;
+        std::size_t hash = 0;
+        std::string_view str;
+    };
+
+    std::array<entry, CACHE_SZ> entries;
+
+    entry& slot(std::size_t hash) { return entries[hash & (CACHE_SZ - 1)]; }
+};
+
+thread_local front_cache thread_cache;
+
+}  // namespace
+
+string_pool::string_pool()
+    : session_id{ session_counter.fetch_add(1, std::memory_order_relaxed) + 1 }
+{
+}
+
+std::string_view string_pool::intern(std::string_view str)
+{
+    if (str.size() > MAX_STRING_SZ) {
+        return {};
+    }
+
+    auto const hash = std::hash<std::string_view>{}(str);
+    auto& cached = thread_cache.slot(hash);
+
+    if (cached.session_id == session_id && cached.hash == hash && cached.str == str) {
+        return cached.str;
+    }
+
+    auto const pooled = intern_locked(str, hash);
+
+    if (pooled.data() != nullptr) {
+        cached = { session_id, hash, pooled };
+    }
+    return pooled;
+}
+
+std::string_view string_pool::intern_locked(std::string_view str, std::size_t hash)
+{
+    // the low bits are used by the thread cache and the hash set
+    auto& shard = shards[(hash >> 16U) & (SHARD_COUNT - 1)];
+
+    std::scoped_lock lock(shard.mutex);
+
+    if (auto const iter = shard.strings.find(str); iter != shard.strings.end()) {
+        return *iter;
+    }
+
+    auto const alloc_size = str.size() + 1;  // including '\0'
+
+    // reserve the size across the shards, the limit is checked along with the reservation
+    auto size = pool_size.load(std::memory_order_relaxed);
+    do {
+        if (size + alloc_size > MAX_POOL_SZ) {
+            return {};
+        }
+    } while (!pool_size.compare_exchange_weak(size, size + alloc_size, std::memory_order_relaxed));
+
+    char* const ptr = shard.storage.allocate(alloc_size);
+    std::memcpy(ptr, str.data(), str.size());
+    ptr[str.size()] = '\0';
+
+    auto const pooled = std::string_view(ptr, str.size());
+    shard.strings.insert(pooled);
+
+    return pooled;
+}
+
+}  // namespace ibis::tool::event_trace::detail
@@ -0,0 +1,101 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <ibis/event_trace/detail/thread_registry.hpp>
+
+#include <type_traits>
+#include <cassert>
+#include <cstdio>
+
+namespace ibis::tool::event_trace {
+
+thread_local thread_registry::record* thread_registry::current_record = nullptr;
+
+thread_registry::record::record(std::size_t index_)
+    : index{ static_cast<index_type>(index_) }
+{
+    attach();
+}
+
+void thread_registry::record::attach()
+{
+    thread_id = current_thread::id();
+    name = { '\0' };
+
+    if (!current_thread::name(name.data(), name.size()) || name[0] == '\0') {
+        static_assert(sizeof(current_thread::id_type) <= sizeof(std::uint64_t),
+                      "string buffer to small for thread ID type!");
+
+        // TODO [C++20] use case for std::format
+        auto constexpr snprintf_fmt = []() {  // quiet warnings
+            if constexpr (std::is_same_v<current_thread::id_type, std::int32_t>) {
+                return "thread-%d";  // e.g. Win32 DWORD (int32_t)
+            }
+            else {
+                return "thread-%lu";  // long unsigned, e.g. Linux
+            }
+        }();
+        [[maybe_unused]] auto const n =
+            std::snprintf(name.data(), name.size(), snprintf_fmt, thread_id);
+        assert(n > 0 && static_cast<std::size_t>(n) < name.size());
+    }
+}
+
+thread_registry::record& thread_registry::acquire()
+{
+    {
+        std::scoped_lock scoped_lock(mutex);
+
+        if (!free_list.empty()) {
+            auto& thread = records[free_list.back()];
+            free_list.pop_back();
+            thread.attach();
+            thread.status.store(state::ACTIVE, std::memory_order_release);
+            return thread;
+        }
+    }
+
+    return records[records.emplace_back_indexed()];
+}
+
+void thread_registry::release_current()
+{
+    if (current_record == nullptr) {
+        return;
+    }
+
+    current_record->status.store(state::EXITED, std::memory_order_release);
+    {
+        std::scoped_lock scoped_lock(mutex);
+        exited.emplace_back(current_record->index);
+    }
+    current_record = nullptr;
+}
+
+std::vector<thread_registry::index_type> thread_registry::take_exited()
+{
+    std::vector<index_type> indices;
+    {
+        std::scoped_lock scoped_lock(mutex);
+        indices.swap(exited);
+    }
+    return indices;
+}
+
+void thread_registry::recycle(std::vector<index_type> const& indices)
+{
+    if (indices.empty()) {
+        return;
+    }
+
+    std::scoped_lock scoped_lock(mutex);
+
+    for (auto const index : indices) {
+        records[index].status.store(state::FREE, std::memory_order_release);
+        free_list.emplace_back(index);
+    }
+}
+
+}  // namespace ibis::tool::event_trace
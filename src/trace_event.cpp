@@ -4,72 +4,200 @@
 //
 
 #include <ibis/event_trace/trace_event.hpp>
-#include <ibis/event_trace/event_trace.hpp>  // FixMe what a named bullshit
-#include <ibis/event_trace/detail/json_formatter.hpp>
-
-#include <fmt/format.h>
-#include <fmt/ostream.h>
-
-#include <range/v3/view/zip.hpp>
-#include <range/v3/algorithm/copy.hpp>
-#include <range/v3/iterator/stream_iterators.hpp>
+#include <ibis/event_trace/trace_site.hpp>
+#include <ibis/event_trace/detail/json_writer.hpp>
+#include <ibis/event_trace/detail/binary_writer.hpp>
+#include <ibis/event_trace/detail/perfetto_writer.hpp>
 
+#include <array>
 #include <chrono>
+#include <string_view>
+#include <utility>
 
 namespace ibis::tool::event_trace {
 
-void TraceEvent::AppendAsJSON(std::string& out) const
+std::int64_t TraceEvent::timestamp_ns(clock::tick_type base_time) const
 {
     using std::chrono::nanoseconds;
     using std::chrono::time_point_cast;
-    namespace views = ranges::views;
 
+    // the recorded raw clock ticks are converted here, not at recording time; time_point_cast's
+    // return type is int64.
+    return time_point_cast<nanoseconds>(clock::time<>::to_time_point(timestamp(base_time)))
+        .time_since_epoch()
+        .count();
+}
+
+std::int64_t TraceEvent::duration_ns() const
+{
+    using std::chrono::nanoseconds;
+
+    return std::chrono::duration_cast<nanoseconds>(clock::time<>::to_duration(duration_)).count();
+}
+
+std::string_view TraceEvent::category_name() const
+{
+    if ((flags & TraceEvent::flag::HAS_SITE) != 0) {
+        return site_->category_name();
+    }
+    return category_name_;
+}
+
+void TraceEvent::AppendAsJSON(std::string& out, flush_context const& context) const
+{
     auto const newline = true; // JSON cosmetic flag
 
-    // time_point_cast's return type is int64.
-    std::int64_t const time_int64 =
-        time_point_cast<nanoseconds>(timestamp_).time_since_epoch().count();
-    current_proc::id_type const process_id = TraceLog::GetInstance().process_id();
-
-    // {fmt} lib printing concept, see https://godbolt.org/z/vMY9W1T7z
-    // note: fmt::memory_buffer's inline_buffer_size = 500 per default
-    auto buf = fmt::basic_memory_buffer<char, 500>();
-    auto back_inserter = std::back_inserter(buf);
-
-    // clang-format off
-    fmt::format_to(back_inserter, 
-        R"({{"cat":"{}","pid":{},"tid":{},"ph":"{}","ts":{},"name":"{}")",
-        category_name_,
-        process_id,
-        thread_id_,
-        phase_,
-        time_int64,
-        event_name_
-    );
-    // clang-format on
-
-    if(arg_names[0] != nullptr) { // one or more args, append "args" JSON object
-        fmt::format_to(back_inserter, R"(,"args":{{)");
-        auto comma = "";
-        for(std::tuple<char const*, trace_value const&> arg : ranges::views::zip(arg_names, arg_values)) {
-            if(std::get<0>(arg) == nullptr) { break; }
-            fmt::format_to(back_inserter, R"({}"{}":{})", // --
-                           comma, std::get<0>(arg), std::get<1>(arg));
-            comma = ",";
+    std::int64_t const time_int64 = timestamp_ns(context.base_time);
+
+    auto json = detail::json_writer(out);
+
+    if ((flags & TraceEvent::flag::HAS_SITE) != 0) {
+        // the call site's constant fragments are already escaped
+        json.literal(site_->json_head());
+        json.literal(context.pid_tid);
+        json.literal(site_->json_phase());
+        json.number(time_int64);
+
+        if (auto const name = site_->json_name(event_name_); !name.empty()) {
+            json.literal(name);
+        }
+        else {
+            json.literal(R"(,"name":)");
+            json.string(event_name_);
+        }
+    }
+    else {
+        json.literal(R"({"cat":)");
+        json.string(category_name_);
+        json.literal(',');
+
+        if (phase_ == TraceEvent::phase::METADATA) {
+            // thread name's metadata are recorded by another thread
+            auto const thread_index = static_cast<thread_registry::index_type>(trace_id_);
+            json.literal(R"("pid":)");
+            json.number(context.process_id);
+            json.literal(R"(,"tid":)");
+            json.number(context.threads[thread_index].thread_id);
         }
-        fmt::format_to(back_inserter, R"(}})");
+        else {
+            json.literal(context.pid_tid);
+        }
+
+        json.literal(R"(,"ph":")");
+        json.literal(static_cast<char>(phase_));
+        json.literal(R"(","ts":)");
+        json.number(time_int64);
+        json.literal(R"(,"name":)");
+        json.string(event_name_);
+    }
+
+    if(arg_count_ != 0) { // one or more args, append "args" JSON object
+        json.literal(R"(,"args":{)");
+        for(std::size_t i = 0; i != arg_count_; ++i) {
+            if (i != 0) {
+                json.literal(',');
+            }
+            json.string(args_[i].name);
+            json.literal(':');
+            json.value(trace_arg::load(args_, arg_count_, i));
+        }
+        json.literal('}');
     }
     else { /* there are no args */ }
-    
+
+    if(phase_ == TraceEvent::phase::COMPLETE) {
+        json.literal(R"(,"dur":)");
+        json.number(duration_ns());
+    }
+
     if((flags & TraceEvent::flag::HAS_ID) != 0) {
-        fmt::format_to(back_inserter, R"(,"id":{})", TraceID::as_TraceID(trace_id_));
+        json.literal(R"(,"id":)");
+        json.hex_string(trace_id_, 8, true);
+    }
+
+    json.literal("},");
+
+    if(newline) { json.literal('\n'); }
+}
+
+void TraceEvent::AppendAsBinary(detail::binary_writer& out, flush_context const& context) const
+{
+    namespace binary_format = detail::binary_format;
+
+    // the string table's records precede the event's record
+    auto const category_id = out.string_id(category_name());
+    auto const name_id = out.string_id(event_name_);
+
+    std::array<std::uint64_t, ARGS_SZ> arg_name_ids;
+    for (std::size_t i = 0; i != arg_count_; ++i) {
+        arg_name_ids[i] = out.string_id(args_[i].name);
+    }
+
+    std::uint8_t binary_flags = binary_format::event_flag::NONE;
+    if ((flags & TraceEvent::flag::HAS_ID) != 0) {
+        binary_flags |= binary_format::event_flag::HAS_ID;
     }
-    
-    fmt::format_to(back_inserter, "}},");
-    
-    if(newline) { fmt::format_to(back_inserter, "\n"); }
+    if (phase_ == TraceEvent::phase::METADATA) {
+        // thread name's metadata are recorded by another thread
+        binary_flags |= binary_format::event_flag::HAS_TID;
+    }
+
+    out.record(binary_format::record::EVENT);
+    out.byte(static_cast<std::uint8_t>(phase_));
+    out.byte(binary_flags);
+    out.varint(category_id);
+    out.varint(name_id);
+    out.timestamp(timestamp_ns(context.base_time));
+
+    if (phase_ == TraceEvent::phase::COMPLETE) {
+        out.varint(static_cast<std::uint64_t>(duration_ns()));
+    }
+    if ((binary_flags & binary_format::event_flag::HAS_ID) != 0) {
+        out.varint(trace_id_);
+    }
+    if ((binary_flags & binary_format::event_flag::HAS_TID) != 0) {
+        auto const thread_index = static_cast<thread_registry::index_type>(trace_id_);
+        out.signed_varint(context.threads[thread_index].thread_id);
+    }
+
+    out.varint(arg_count_);
+    for (std::size_t i = 0; i != arg_count_; ++i) {
+        out.varint(arg_name_ids[i]);
+        out.value(trace_arg::load(args_, arg_count_, i));
+    }
+}
+
+void TraceEvent::AppendAsPerfetto(detail::perfetto_writer& out, flush_context const& context) const
+{
+    std::array<std::pair<char const*, trace_value>, ARGS_SZ> args;
+    for (std::size_t i = 0; i != arg_count_; ++i) {
+        args[i] = { args_[i].name, trace_arg::load(args_, arg_count_, i) };
+    }
+
+    if (phase_ == TraceEvent::phase::METADATA) {
+        // thread name's metadata are recorded by another thread, other metadata aren't mapped
+        auto const& value = args[0].second;
+        if (std::string_view{ event_name_ } == "thread_name" && arg_count_ != 0 &&
+            value.type_tag() == trace_value::type::STRING && value.data().str != nullptr) {
+            auto const thread_index = static_cast<thread_registry::index_type>(trace_id_);
+            out.thread_name(context.process_id, context.threads[thread_index].thread_id,
+                            value.data().str);
+        }
+        return;
+    }
+
+    auto const has_id = (flags & TraceEvent::flag::HAS_ID) != 0;
 
-    out.append(buf.begin(), buf.end());
+    out.track_event({
+        .phase = static_cast<char>(phase_),
+        .category_name = category_name(),
+        .event_name = event_name_,
+        .timestamp = timestamp_ns(context.base_time),
+        .duration = (phase_ == TraceEvent::phase::COMPLETE) ? duration_ns() : 0,
+        .trace_id = has_id ? trace_id_ : 0,  // shared with COMPLETE's duration
+        .has_id = has_id,
+        .args = std::span{ args.data(), arg_count_ },
+    });
 }
 
 }  // namespace ibis::tool::event_trace
@@ -10,29 +10,14 @@
 
 #include <ibis/event_trace/detail/clock.hpp>
 #include <ibis/event_trace/detail/platform.hpp>
+#include <ibis/event_trace/detail/json_writer.hpp>
 
 #include <fmt/format.h>
 
 #include <cassert>
 #include <algorithm>
+#include <array>
 #include <string_view>
-#include <iostream>
-
-namespace /* anonymous */ {
-
-// Flag to indicate whether we captured the current thread before
-static thread_local bool current_thread_id_captured;
-
-template <typename Arg, typename... Args>
-void dbg_print(Arg&& arg, Args&&... args)
-{
-    if constexpr ((false)) { // NOLINT(readability-simplify-boolean-expr)
-        std::cout << std::forward<Arg>(arg);
-        ((std::cout << std::forward<Args>(args)), ...);
-    }
-}
-
-}  // namespace
 
 namespace ibis::tool::event_trace {
 
@@ -40,14 +25,34 @@ namespace ibis::tool::event_trace {
 // TraceLog
 //
 
+thread_local TraceLog::thread_local_chunk TraceLog::current_chunk_;
+
+TraceLog::thread_local_chunk::~thread_local_chunk()
+{
+    auto& trace_log = TraceLog::GetInstance();
+    std::scoped_lock scoped_lock(trace_log.lock_);
+
+    // the thread's record is recycled after the chunk handed over is flushed
+    trace_log.retire_chunk(*this);
+    trace_log.thread_registry_.release_current();
+}
+
 TraceLog::TraceLog()
     : process_id_{ current_proc::id() }
     , process_id_hash_{ std::hash<current_proc::id_type>()(process_id_) }
     , enabled_{ false }
 {
-    // both requires reserve(), see https://coliru.stacked-crooked.com/a/bb1b21a7696f1249
-    logged_events_.reserve(TraceLog::BUFFER_SZ);
-    flush_events_.reserve(TraceLog::BUFFER_SZ);
+    // chunks are allocated on demand
+    chunks_.reserve(TraceLog::MAX_CHUNKS);
+    free_chunks_.reserve(TraceLog::MAX_CHUNKS);
+    bound_chunks_.reserve(TraceLog::MAX_CHUNKS);
+    flush_chunks_.reserve(TraceLog::MAX_CHUNKS);
+}
+
+TraceLog::~TraceLog()
+{
+    // no output on static destruction, the callback's sink may be gone already
+    stop_flusher(false);
 }
 
 void TraceLog::SetProcessID(current_proc::id_type process_id)
@@ -89,115 +94,221 @@ void TraceLog::SetEnabled(bool enabled)
 #endif
     }
 
-    Flush();
+    flush_or_request();
+}
+
+std::size_t TraceLog::GetEventsCount() const
+{
+    std::scoped_lock scoped_lock(lock_);
+
+    std::size_t count = 0;
+    for (auto const& chunk : chunks_) {
+        count += chunk->size() - chunk->flushed_count();
+    }
+    return count;
 }
 
 float TraceLog::GetEventBufferPercentFull() const
 {
-    return static_cast<float>(logged_events_.size()) / static_cast<float>(TraceLog::BUFFER_SZ);
+    std::size_t capacity = 0;
+    {
+        std::scoped_lock scoped_lock(lock_);
+        capacity = max_chunks_ * event_chunk::CHUNK_SZ;
+    }
+    return static_cast<float>(GetEventsCount()) / static_cast<float>(capacity);
 }
 
-std::int32_t TraceLog::AddTraceEventInternal(                           // --
-    TraceEvent::phase phase,                                            // --
-    std::string_view category_name, std::string_view event_name,        // --
-    std::uint64_t trace_id, TraceEvent::flag flags,                     // --
-    std::int32_t threshold_begin_id, clock::duration_type threshold,    // --
-    TraceEvent::storage_ptr ptr,                                        // --
-    std::string_view arg1_name, trace_value arg1_value                  // --
-    )
+void TraceLog::SetBufferMode(buffer_mode mode, std::size_t event_count,
+                             clock::duration_type max_age)
 {
-    assert(category_name.size() > 0 && "category_name must not be empty");
-    assert(event_name.size() > 0 && "event_name must not be empty");
+    // round up to whole chunks
+    auto const chunk_count = (event_count + event_chunk::CHUNK_SZ - 1) / event_chunk::CHUNK_SZ;
 
-    if (logged_events_.size() >= TraceLog::BUFFER_SZ) {
-        return TraceLog::EVENT_ID_NONE;
+    std::scoped_lock scoped_lock(lock_);
+
+    buffer_mode_ = mode;
+    max_chunks_ = std::clamp(chunk_count, std::size_t{ 1 }, TraceLog::MAX_CHUNKS);
+    max_age_ = (mode == buffer_mode::RING) ? max_age : clock::duration_zero;
+
+    // release the surplus of unused chunks, the others on recycling
+    while (chunks_.size() > max_chunks_ && !free_chunks_.empty()) {
+        auto* const chunk = free_chunks_.back();
+        free_chunks_.pop_back();
+        std::erase_if(chunks_, [chunk](auto const& owned) { return owned.get() == chunk; });
     }
+}
 
-    std::scoped_lock scoped_lock(lock_);
+event_chunk* TraceLog::thread_chunk()
+{
+    auto& local = current_chunk_;
+    auto const generation = generation_.load(std::memory_order_relaxed);
 
-    current_thread::id_type const thread_id = current_thread::id();
+    if (local.chunk != nullptr) {
+        if (!local.chunk->full() && local.chunk->bound_generation() == generation) {
+            return local.chunk;
+        }
+    }
+    else if (local.exhausted && local.exhausted_generation == generation) {
+        // don't retry before the next flush has released chunks
+        return nullptr;
+    }
 
-    // don't move the time capture point, so it's independet of the code path below
-    auto const time_point = clock::time<>::now();
+    return swap_chunk(local);
+}
 
+event_chunk* TraceLog::swap_chunk(thread_local_chunk& local)
+{
     // record the name of the calling thread, if not done already.
-    if (!current_thread_id_captured) {
-        std::cout << "Debug: Thread ID " << thread_id << " just initialized TLS\n";
-        auto const iter = std::find(thread_ids_seen.begin(), thread_ids_seen.end(), thread_id);
+    auto const thread_index = thread_registry_.current().index;
 
-        if (iter == thread_ids_seen.end()) {
-            std::cout << "Debug: Add Thread ID " << thread_id << "\n";
-            thread_ids_seen.emplace_back(thread_id);
-        }
-        else {
-            // This is a thread id that's seen before, but potentially with a
-            // new name.
-            // std::cout << "Debug: Thread ID seen, but TLS already initialized.\n";
-        }
-        // FixMe: Chromium's event_trace hasn't this!
-        current_thread_id_captured = true;
+    std::unique_lock unique_lock(lock_);
+
+    auto const generation = generation_.load(std::memory_order_relaxed);
+
+    retire_chunk(local);
+
+    auto* const chunk = allocate_chunk();
+
+    if (chunk != nullptr) {
+        chunk->bind(generation, local.next_event_id, thread_index, string_pool_);
+        bound_chunks_.emplace_back(chunk);
+        local.chunk = chunk;
+        local.exhausted = false;
+    }
+    else {
+        local.exhausted = true;
+        local.exhausted_generation = generation;
     }
 
-    // Check on threshold duration events, only record the event if the duration is greater than
-    // the specified threshold duration.
-    if (threshold_begin_id > TraceLog::EVENT_ID_NONE) {
-        assert(phase == TraceEvent::phase::END);
+    // let the background flusher do the serialization, never on the recording thread
+    bool const wake_flusher = flush_required() || chunk == nullptr;
+    unique_lock.unlock();
 
-        // the event ID where the scope started
-        auto const event_id = static_cast<std::size_t>(threshold_begin_id);
+    if (wake_flusher && IsFlusherRunning()) {
+        request_flush();  // the events are kept if the flusher is stopped meanwhile
+    }
 
-        dbg_print("TraceEndOnScopeCloseThreshold '", category_name, "/", event_name, "':\n");
+    return chunk;
+}
 
-        // <begin event> has been flushed out before, discard <end event> since it's
-        // unreachable
-        // --------------------------------------------------------------------------
-        // FixMe: CheckMe: Since we swap and flush vectors, vector's size() maybe not
-        // appropriate!! Consider global, run- and lifetime ID (static counter increment)
-        // --------------------------------------------------------------------------
-        if (event_id >= logged_events_.size()) {
-            dbg_print("  => discard event: not anymore logged, probably flushed before.\n");
-            return TraceLog::EVENT_ID_NONE;
-        }
+event_chunk* TraceLog::allocate_chunk()
+{
+    if (!free_chunks_.empty()) {
+        auto* const chunk = free_chunks_.back();
+        free_chunks_.pop_back();
+        return chunk;
+    }
 
-        // Determine whether to drop the begin/end pair.
-        auto const elapsed = time_point - logged_events_[event_id].timestamp();
-
-        dbg_print(
-            "  elapsed = ", std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
-            "ns, threshold = ", threshold.count(), "ns\n");
-
-        if (elapsed < threshold) {
-            // Remove <begin event> and do not add <end event>.
-            // This will be expensive if there have been other events in the
-            // mean time (should be rare).
-            // --------------------------------------------------------------------------
-            // FixMe: This invalidates all other event_id (even iterators, which isn't
-            // problematic here)! This may affect other TraceEndOnScopeCloseThreshold events.
-            // Maybe extend the flag e.g. with 0xFF = ORPHANED
-            // --------------------------------------------------------------------------
-            dbg_print("  => discard event\n");
-            using difference_type =
-                typename std::iterator_traits<std::vector<TraceEvent>::iterator>::difference_type;
-            logged_events_.erase(logged_events_.begin() + static_cast<difference_type>(event_id));
-            return TraceLog::EVENT_ID_NONE;
+    if (chunks_.size() < max_chunks_) {
+        return chunks_.emplace_back(std::make_unique<event_chunk>()).get();
+    }
+
+    if (buffer_mode_ == buffer_mode::RING) {
+        // overwrite the oldest events, the retired chunks are ordered by hand over time; the
+        // chunks serialized by a running flush are skipped
+        auto const oldest = std::ranges::find_if(
+            retired_chunks_, [](event_chunk const* chunk) { return !chunk->flushing(); });
+        if (oldest != retired_chunks_.end()) {
+            auto* const chunk = *oldest;
+            retired_chunks_.erase(oldest);
+            chunk->clear();
+            return chunk;
         }
+    }
+
+    return nullptr;
+}
+
+bool TraceLog::flush_required() const
+{
+    auto const fill_level =
+        static_cast<float>(retired_chunks_.size()) / static_cast<float>(max_chunks_);
+    return fill_level >= flusher_fill_level_;
+}
+
+void TraceLog::retire_chunk(thread_local_chunk& local)
+{
+    auto* const chunk = local.chunk;
+
+    if (chunk == nullptr) {
+        return;
+    }
+
+    local.next_event_id = chunk->next_event_id();
+    local.chunk = nullptr;
+
+    std::erase(bound_chunks_, chunk);
 
-        dbg_print("  => log event\n");
+    if (chunk->flushing()) {
+        retired_chunks_.emplace_back(chunk);  // the running flush still reads the chunk
+    }
+    else if (chunk->size() == chunk->flushed_count()) {
+        recycle_chunk(chunk);  // no events or all flushed already
+    }
+    else {
+        retired_chunks_.emplace_back(chunk);
+    }
+}
+
+void TraceLog::recycle_chunk(event_chunk* chunk)
+{
+    if (chunks_.size() > max_chunks_) {
+        // the buffer size was lowered
+        std::erase_if(chunks_, [chunk](auto const& owned) { return owned.get() == chunk; });
+        return;
     }
 
+    chunk->clear();
+    free_chunks_.emplace_back(chunk);
+}
+
+std::int32_t TraceLog::AddTraceEventInternal(                           // --
+    TraceEvent::phase phase,                                            // --
+    std::string_view category_name, std::string_view event_name,        // --
+    std::uint64_t trace_id, TraceEvent::flag flags,                     // --
+    clock::tick_type timestamp, clock::tick_type duration,              // --
+    event_chunk* chunk,                                                 // --
+    std::span<std::string_view const> arg_names,                        // --
+    std::span<trace_value const> arg_values,                            // --
+    trace_site const* site                                              // --
+    )
+{
+    assert(category_name.size() > 0 && "category_name must not be empty");
+    assert(event_name.size() > 0 && "event_name must not be empty");
+    assert(chunk != nullptr && "chunk must be acquired by thread_chunk() before");
+    assert(arg_names.size() == arg_values.size() && "arguments must be pairs of name and value");
+    assert(arg_names.size() <= TraceEvent::ARGS_SZ && "too many arguments");
+
     if ((flags & TraceEvent::flag::MANGLE_ID) != 0) {
         trace_id ^= process_id_hash_;
     }
 
-    // use the current length of traced events as ID of event
-    std::int32_t const event_id = static_cast<std::int32_t>(logged_events_.size());
+    // use the thread's event sequence as ID of event
+    std::int32_t const event_id = chunk->next_event_id();
+
+    // complete events are recorded at their end, so the thread's events are ordered by time
+    clock::tick_type const record_time =
+        (phase == TraceEvent::phase::COMPLETE) ? timestamp + duration : timestamp;
+
+    if (!chunk->fits(record_time)) {
+        flags |= TraceEvent::flag::FULL_TIME;
+    }
+
+    // the arguments (and the time stamp not fitting) are stored in the chunk's side area
+    std::size_t const arg_count = arg_names.size();
+    trace_arg* const args = chunk->allocate_args(record_time, arg_count);
+
+    for (std::size_t i = 0; i != arg_count; ++i) {
+        assert(strlen(arg_names[i].data()) == arg_names[i].size() && "unexpected strlen for arg_name");
+        trace_arg::store(args, arg_count, i, arg_names[i].data(), arg_values[i]);
+    }
 
-    logged_events_.emplace_back(           // TraceEvent(...)
-        thread_id, time_point,             // --
+    chunk->emplace_back(                   // TraceEvent(...)
+        record_time, duration,             // --
         phase, category_name, event_name,  // --
         trace_id, flags,                   // --
-        std::move(ptr),                    // --
-        arg1_name, arg1_value              // --
+        args, arg_count,                   // --
+        site                               // --
         );
 
     return event_id;
@@ -205,15 +316,46 @@ std::int32_t TraceLog::AddTraceEventInternal(                           // --
 
 void TraceLog::Flush()
 {
+    std::scoped_lock flush_lock(flush_lock_);
+
+    clock::duration_type max_age = clock::duration_zero;
+    std::vector<thread_registry::index_type> exited_threads;
     {
         std::scoped_lock scoped_lock(lock_);
-        flush_events_.swap(logged_events_);
-        logged_events_.clear();
 
-        // ensure, that clearing data doesn't resize memory capacity unintentionally.
-        // assert(logged_events_.capacity() == BUFFER_SZ);
+        // hand over the own events and request all other threads to do so on their next event
+        retire_chunk(current_chunk_);
+        generation_.fetch_add(1, std::memory_order_relaxed);
+
+        for (auto* const chunk : retired_chunks_) {
+            flush_chunks_.emplace_back(
+                flush_range{ chunk, chunk->flushed_count(), chunk->size(), false });
+        }
+        retired_chunks_.clear();
+
+        // the threads being idle or blocked don't hand over their chunk, hence the events
+        // published so far are flushed while the threads may go on recording
+        for (auto* const chunk : bound_chunks_) {
+            auto const published = chunk->size();
+            if (published != chunk->flushed_count()) {
+                chunk->set_flushing(true);
+                flush_chunks_.emplace_back(
+                    flush_range{ chunk, chunk->flushed_count(), published, true });
+            }
+        }
+
+        // the exited threads' chunks are handed over, hence all their events are flushed now
+        exited_threads = thread_registry_.take_exited();
+
+        max_age = max_age_;
     }
 
+    // flight recorder's time window, events recorded before are discarded.
+    auto const has_time_window = max_age != clock::duration_zero;
+    auto const now_ticks = clock::time<>::ticks();
+    auto const max_age_ticks = clock::time<>::to_ticks(max_age);
+    auto const oldest_time_point = (now_ticks > max_age_ticks) ? now_ticks - max_age_ticks : 0;
+
     // FixMe: [C++20] using move constructor with reserved memory allows to use this pre-allocated
     // memory, see https://coliru.stacked-crooked.com/a/eaf6b311418f131e; maybe custom allocator is
     // the only reasonable-ish way of doing it. For making a custom allocator I'd probably have
@@ -223,26 +365,293 @@ void TraceLog::Flush()
     // that allocator as a member that would be like a dependency injected custom allocator which is
     // good for composition which works into the Alexandrescu talk
     auto json_str = std::string();
-    json_str.reserve(4096);  // FixMe: Check the size value
+    json_str.reserve(TraceLog::BATCH_SZ * 128);  // FixMe: Check the size value
+
+    struct flush_batch {
+        event_chunk const* chunk;
+        flush_context const* context;
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    auto const AppendEventsAsJSON = [&](flush_batch const& batch, std::string& out) {
+        auto const events = batch.chunk->data();
+        for (auto i = batch.begin; i != batch.end; ++i) {
+            auto const& event = events[i];
+            if (has_time_window && event.timestamp(batch.chunk->base()) < oldest_time_point) {
+                continue;
+            }
+            event.AppendAsJSON(out, *batch.context);
+        }
+    };
+
+    // the process ID is the same for all events of this flush
+    current_proc::id_type const process_id = process_id_;
+
+    // The chunks' serialization context, all events of a chunk are recorded by the same thread.
+    // The pid_tid strings are reserved, the contexts refer to them.
+    auto pid_tids = std::vector<std::string>();
+    auto contexts = std::vector<flush_context>();
+    pid_tids.reserve(flush_chunks_.size());
+    contexts.reserve(flush_chunks_.size());
+
+    auto batches = std::vector<flush_batch>();
 
-    auto const AppendEventsAsJSON = [](std::vector<TraceEvent> const& events, std::size_t start,
-                                       std::size_t count, std::string& out) {
-        for (std::size_t i = 0; i < count && (start + i) < events.size(); ++i) {
-            events[i + start].AppendAsJSON(out);
+    for (auto const& range : flush_chunks_) {
+        auto const* const chunk = range.chunk;
+
+        if (range.begin == range.end) {
+            continue;
+        }
+        if (has_time_window && chunk->latest() < oldest_time_point) {
+            continue;  // whole chunk is out of time window
+        }
+
+        auto& pid_tid = pid_tids.emplace_back();
+        {
+            auto json = detail::json_writer(pid_tid);
+            json.literal(R"("pid":)");
+            json.number(process_id);
+            json.literal(R"(,"tid":)");
+            json.number(thread_registry_[chunk->thread()].thread_id);
+        }
+        auto const& context = contexts.emplace_back(flush_context{
+            thread_registry_, process_id, chunk->thread(), chunk->base(), pid_tid });
+
+        for (auto i = range.begin; i < range.end; i += TraceLog::BATCH_SZ) {
+            batches.emplace_back(flush_batch{ chunk, &context, i,  // --
+                                              std::min(i + TraceLog::BATCH_SZ, range.end) });
+        }
+    }
+
+    // the binary formats are serialized in order by this thread
+    auto const serialize = [&](auto& writer, auto append) {
+        writer.clear_cache();  // the flushed chunks' strings are reused afterwards
+        for (auto const& batch : batches) {
+            writer.clear();
+            writer.thread(batch.context->process_id,
+                          thread_registry_[batch.context->thread_index].thread_id);
+            auto const events = batch.chunk->data();
+            for (auto i = batch.begin; i != batch.end; ++i) {
+                auto const& event = events[i];
+                if (has_time_window &&
+                    event.timestamp(batch.chunk->base()) < oldest_time_point) {
+                    continue;
+                }
+                (event.*append)(writer, *batch.context);
+            }
+            output_callback(writer.data());
         }
     };
 
-    for (std::size_t i = 0; i < flush_events_.size(); i += TraceLog::BATCH_SZ) {
-        json_str.clear();
-        AppendEventsAsJSON(flush_events_, i, TraceLog::BATCH_SZ, json_str);
-        output_callback(json_str);
+    if (session_format_ == output_format::BINARY) {
+        serialize(*binary_writer_, &TraceEvent::AppendAsBinary);
+    }
+    else if (session_format_ == output_format::PERFETTO) {
+        serialize(*perfetto_writer_, &TraceEvent::AppendAsPerfetto);
+    }
+    else if (flush_pool_ == nullptr || batches.size() < 2) {
+        for (auto const& batch : batches) {
+            json_str.clear();
+            AppendEventsAsJSON(batch, json_str);
+            output_callback(json_str);
+        }
+    }
+    else {
+        // Serialize a window of batches in parallel, each into its own buffer, and pass them in
+        // order to the output callback. The window limits the memory of the buffers.
+        auto const window_sz = flush_pool_->size() * TraceLog::BATCHES_PER_THREAD;
+        auto buffers = std::vector<std::string>(std::min(window_sz, batches.size()));
+
+        for (std::size_t window = 0; window < batches.size(); window += window_sz) {
+            auto const count = std::min(window_sz, batches.size() - window);
+
+            flush_pool_->run(count, [&](std::size_t i) {
+                auto const& batch = batches[window + i];
+                auto& buffer = buffers[i];
+                buffer.clear();
+                buffer.reserve(TraceLog::BATCH_SZ * 128);
+                AppendEventsAsJSON(batch, buffer);
+            });
+
+            for (std::size_t i = 0; i != count; ++i) {
+                output_callback(buffers[i]);
+            }
+        }
+    }
+
+    {
+        std::scoped_lock scoped_lock(lock_);
+
+        // recycle the flushed chunks, the bound ones are recycled on hand over
+        for (auto const& range : flush_chunks_) {
+            auto* const chunk = range.chunk;
+            if (range.bound) {
+                chunk->set_flushed_count(range.end);
+                chunk->set_flushing(false);
+                continue;
+            }
+            recycle_chunk(chunk);
+        }
+        flush_chunks_.clear();
+    }
+
+    thread_registry_.recycle(exited_threads);
+}
+
+void TraceLog::SetFlushThreads(std::size_t thread_count)
+{
+    std::scoped_lock flush_lock(flush_lock_);
+
+    if (thread_count < 2) {
+        flush_pool_.reset();
+        return;
+    }
+    if (flush_pool_ != nullptr && flush_pool_->size() == thread_count) {
+        return;
+    }
+
+    flush_pool_.reset();  // join the old threads first
+    flush_pool_ = std::make_unique<detail::worker_pool>(thread_count);
+}
+
+void TraceLog::SetOutputFormat(output_format format)
+{
+    std::scoped_lock flush_lock(flush_lock_);
+    output_format_ = format;
+}
+
+void TraceLog::StartFlusher(float fill_level, clock::duration_type interval)
+{
+    std::scoped_lock scoped_lock(flusher_mutex_);
+
+    if (flusher_.joinable()) {
+        return;
+    }
+
+    {
+        std::scoped_lock chunk_lock(lock_);  // read by flush_required()
+        flusher_fill_level_ = fill_level;
+    }
+    flusher_interval_ = interval;
+    flusher_stop_ = false;
+    flusher_final_flush_ = true;
+    flush_requested_ = false;
+
+    flusher_ = std::thread([this]() { flusher_loop(); });
+    flusher_running_.store(true, std::memory_order_relaxed);
+}
+
+void TraceLog::StopFlusher() { stop_flusher(true); }
+
+void TraceLog::stop_flusher(bool final_flush)
+{
+    std::thread flusher;
+    {
+        std::scoped_lock scoped_lock(flusher_mutex_);
+
+        if (!flusher_.joinable()) {
+            return;
+        }
+
+        // from now on requests are rejected, hence the callers flush on their own
+        flusher_running_.store(false, std::memory_order_relaxed);
+        flusher_stop_ = true;
+        flusher_final_flush_ = final_flush;
+        flusher = std::move(flusher_);
+    }
+
+    flusher_cv_.notify_one();
+    flusher.join();
+}
+
+bool TraceLog::request_flush()
+{
+    {
+        std::scoped_lock scoped_lock(flusher_mutex_);
+
+        if (!flusher_running_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        flush_requested_ = true;
+    }
+    flusher_cv_.notify_one();
+    return true;
+}
+
+void TraceLog::flush_or_request()
+{
+    if (!request_flush()) {
+        Flush();
+    }
+}
+
+void TraceLog::flusher_loop()
+{
+    auto const wake_up = [this]() { return flusher_stop_ || flush_requested_; };
+
+    std::unique_lock unique_lock(flusher_mutex_);
+
+    for (;;) {
+        if (flusher_interval_ == clock::duration_zero) {
+            flusher_cv_.wait(unique_lock, wake_up);
+        }
+        else {
+            flusher_cv_.wait_for(unique_lock, flusher_interval_, wake_up);
+        }
+
+        if (flusher_stop_ && !flusher_final_flush_) {
+            break;
+        }
+
+        // a request accepted while flushing is served by another pass, also on stop
+        bool const stop = flusher_stop_;
+        flush_requested_ = false;
+
+        unique_lock.unlock();
+        Flush();
+        unique_lock.lock();
+
+        if (stop) {
+            break;
+        }
     }
 }
 
 void TraceLog::BeginLogging()
 {
+    // calibrate the clock before recording, not within the first trace event
+    clock::time<>::init();
+
     SetEnabled(true);
 
+    std::scoped_lock flush_lock(flush_lock_);
+
+    {
+        // new trace session, the chunks get the new string pool on next binding
+        std::scoped_lock scoped_lock(lock_);
+        string_pool_ = std::make_shared<detail::string_pool>();
+        generation_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    session_format_ = output_format_;
+
+    if (session_format_ == output_format::BINARY) {
+        binary_writer_ = std::make_unique<detail::binary_writer>();
+        binary_writer_->reserve(TraceLog::BATCH_SZ * 32);
+        binary_writer_->header();
+        output_callback(binary_writer_->data());
+        return;
+    }
+
+    if (session_format_ == output_format::PERFETTO) {
+        perfetto_writer_ = std::make_unique<detail::perfetto_writer>();
+        perfetto_writer_->reserve(TraceLog::BATCH_SZ * 64);
+        perfetto_writer_->header(process_id_);
+        output_callback(perfetto_writer_->data());
+        return;
+    }
+
     auto buf = fmt::memory_buffer();
     auto back_inserter = std::back_inserter(buf);
 
@@ -250,9 +659,30 @@ void TraceLog::BeginLogging()
     output_callback(to_string(buf));
 }
 
-// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
-void TraceLog::EndLogging()  // -- maybe later static
+void TraceLog::EndLogging()
 {
+    StopFlusher();
+
+    std::scoped_lock flush_lock(flush_lock_);
+
+    {
+        // the pool is released with the last chunk referring to it
+        std::scoped_lock scoped_lock(lock_);
+        string_pool_.reset();
+        generation_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (session_format_ == output_format::BINARY) {
+        binary_writer_->clear();
+        binary_writer_->footer();
+        output_callback(binary_writer_->data());
+        return;  // the writer is kept for events flushed later, as on JSON
+    }
+
+    if (session_format_ == output_format::PERFETTO) {
+        return;  // the packet stream has no trailer, the writer is kept as above
+    }
+
     auto buf = fmt::memory_buffer();
     auto back_inserter = std::back_inserter(buf);
 
@@ -262,43 +692,30 @@ void TraceLog::EndLogging()  // -- maybe later static
 
 void TraceLog::AddThreadNameMetadataEvents()
 {
-    for (auto const id : thread_ids_seen) {
-        // buffer's worst case scenario: thread ID is of uint64, hence log10(2^64) ~ 20 digits.
-        // With leading string 'thread-' (7 bytes) and '\0' at least 28 bytes are required.
-        static constexpr std::size_t alloc_size = 32;
-        static_assert(sizeof(decltype(id)) <= sizeof(std::uint64_t),
-                      "string buffer to small for thread ID type!");
-
-        // We could invoke TraceLog::copy() API to make a deep copy, but we shorten it to:
-
-        // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
-        TraceEvent::storage_ptr ptr = std::make_unique<char[]>(alloc_size);
-
-        // TODO [C++20] use case for std::format
-        // see https://stackoverflow.com/questions/60450200/forcing-format-to-n-to-use-terminating-zero
-        auto constexpr snprintf_fmt = []() {  // quiet warnings
-            if constexpr (std::is_same_v<current_thread::id_type, std::int32_t>) {
-                return "thread-%d";  // e.g. Win32 DWORD (int32_t)
-            }
-            else {
-                return "thread-%lu";  // long unsigned, e.g. Linux
-            }
-        }();
-        auto const n = snprintf(ptr.get(), alloc_size - 1, snprintf_fmt, id);
-        assert(!(n < 0));         // error must not occur here
-        assert(n != alloc_size);  // truncated to limit, means buffer to small
-        auto const count = static_cast<std::size_t>(n);
-        ptr[count] = '\0';
-
-        logged_events_.emplace_back(                     // TraceEvent(...)
-            id, clock::time<>::now(),                    // -- thead_id, time point
+    // the records aren't recycled meanwhile and the events refer to them until flushed
+    std::scoped_lock flush_lock(flush_lock_);
+
+    thread_registry_.for_each([this](thread_registry::record const& thread) {
+        auto* const chunk = thread_chunk();
+
+        if (chunk == nullptr) {
+            return;
+        }
+
+        // the registry's record isn't reused before the event is flushed, no copy is required
+        std::array<std::string_view, 1> const arg_names = { "name" };
+        std::array<trace_value, 1> const arg_values = { trace_value(thread.thread_name()) };
+
+        // recorded into the calling thread's chunk, the named thread is given by the ID
+        AddTraceEventInternal(                           // --
             TraceEvent::phase::METADATA,                 // -- phase
             "__metadata", "thread_name",                 // -- category, event name
-            0, TraceEvent::flag::NONE,                   // -- id, flags
-            std::move(ptr),                              // --
-            "name", std::string_view(ptr.get(), count)   // -- argument { key : value }
+            thread.index, TraceEvent::flag::NONE,        // -- thread index as id, flags
+            clock::time<>::ticks(), 0,                   // -- time point, duration
+            chunk,                                       // --
+            arg_names, arg_values                        // -- argument { key : value }
             );
-    }
+    });
 }
 
 #if 0  // old way
@@ -341,6 +758,6 @@ void TraceLog::OutputCallback(std::string_view out)
 }
 #endif
 
-void TraceLog::BufferFullCallback() { TraceLog::GetInstance().Flush(); }
+void TraceLog::BufferFullCallback() { TraceLog::GetInstance().flush_or_request(); }
 
 }  // namespace ibis::tool::event_trace
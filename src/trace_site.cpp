@@ -0,0 +1,74 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <ibis/event_trace/trace_site.hpp>
+#include <ibis/event_trace/detail/json_writer.hpp>
+#include <ibis/event_trace/detail/arena.hpp>
+
+#include <string>
+#include <mutex>
+#include <cstring>
+
+namespace ibis::tool::event_trace {
+
+namespace /* anonymous */ {
+
+///
+/// Storage of the sites' strings, shared by all sites. It's never destroyed, so the strings are
+/// valid until the process ends - also for a flush during static destruction.
+///
+class site_storage {
+public:
+    static site_storage& instance()
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-owning-memory) - intentionally leaked
+        static auto* const static_instance = new site_storage;
+        return *static_instance;
+    }
+
+    /// Make a '\0' terminated copy of @a str in the storage.
+    std::string_view copy(std::string_view str)
+    {
+        std::scoped_lock lock(mutex);
+
+        char* const ptr = storage.allocate(str.size() + 1);
+        std::memcpy(ptr, str.data(), str.size());
+        ptr[str.size()] = '\0';
+        return { ptr, str.size() };
+    }
+
+private:
+    std::mutex mutex;
+    detail::arena storage;
+};
+
+}  // namespace
+
+void trace_site::build()
+{
+    std::string buf;
+    auto json_writer = detail::json_writer(buf);
+
+    json_writer.literal(R"({"cat":)");
+    json_writer.string(proxy_.category_name());
+    json_writer.literal(',');
+    head_sz = buf.size();
+
+    json_writer.literal(R"(,"ph":")");
+    json_writer.literal(static_cast<char>(phase_));
+    json_writer.literal(R"(","ts":)");
+    phase_sz = buf.size() - head_sz;
+
+    if (event_name_ != nullptr) {
+        json_writer.literal(R"(,"name":)");
+        json_writer.string(event_name_);
+    }
+
+    auto& storage = site_storage::instance();
+    category_name_ = storage.copy(proxy_.category_name());
+    json = storage.copy(buf);
+}
+
+}  // namespace ibis::tool::event_trace
@@ -0,0 +1,109 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <ibis/event_trace/detail/worker_pool.hpp>
+
+namespace ibis::tool::event_trace::detail {
+
+worker_pool::worker_pool(std::size_t thread_count)
+{
+    // the calling thread of run() is the one left
+    auto const worker_count = (thread_count > 1) ? thread_count - 1 : 0;
+
+    workers.reserve(worker_count);
+    for (std::size_t i = 0; i != worker_count; ++i) {
+        workers.emplace_back([this]() { worker_loop(); });
+    }
+}
+
+worker_pool::~worker_pool()
+{
+    {
+        std::scoped_lock scoped_lock(mutex);
+        stop = true;
+    }
+    start_cv.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void worker_pool::run(std::size_t count, task_type const& task)
+{
+    {
+        std::scoped_lock scoped_lock(mutex);
+        job_task = &task;
+        job_count = count;
+        next_index.store(0, std::memory_order_relaxed);
+        ++job_id;
+    }
+    start_cv.notify_all();
+
+    execute(task, count);
+
+    std::exception_ptr job_error;
+    {
+        std::unique_lock unique_lock(mutex);
+        done_cv.wait(unique_lock, [this]() { return busy == 0; });
+
+        // workers waking up late find no job
+        job_task = nullptr;
+        job_count = 0;
+        std::swap(job_error, error);
+    }
+
+    if (job_error) {
+        std::rethrow_exception(job_error);
+    }
+}
+
+void worker_pool::worker_loop()
+{
+    std::uint64_t last_job_id = 0;
+
+    std::unique_lock unique_lock(mutex);
+    for (;;) {
+        start_cv.wait(unique_lock, [&]() { return stop || job_id != last_job_id; });
+        if (stop) {
+            return;
+        }
+        last_job_id = job_id;
+
+        if (job_task == nullptr) {
+            continue;  // job is already done
+        }
+
+        auto const* const task = job_task;
+        auto const count = job_count;
+        ++busy;
+
+        unique_lock.unlock();
+        execute(*task, count);
+        unique_lock.lock();
+
+        if (--busy == 0) {
+            done_cv.notify_one();
+        }
+    }
+}
+
+void worker_pool::execute(task_type const& task, std::size_t count)
+{
+    for (auto index = next_index.fetch_add(1, std::memory_order_relaxed); index < count;
+         index = next_index.fetch_add(1, std::memory_order_relaxed)) {
+        try {
+            task(index);
+        }
+        catch (...) {
+            std::scoped_lock scoped_lock(mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+}
+
+}  // namespace ibis::tool::event_trace::detail
@@ -526,14 +526,7 @@ BOOST_FIXTURE_TEST_CASE(threshold_test, proxy_fixture)
 
         // implementation of INTERNAL_TRACE_EVENT_ADD_SCOPED_IF_LONGER_THAN()
         static auto const category_proxy = category::get("threshold_test");
-        TraceEndOnScopeCloseThreshold scope_guard(category_proxy, "longer_than_42us", threshold);
-
-        if (category_proxy) {
-            auto const begin_event_id =
-                AddTraceEvent(TraceEvent::phase::BEGIN, category_proxy.category_name(),
-                              "maybe_longer_than_42us", 0, TraceEvent::flag::NONE);
-            scope_guard.set_threshold_begin_id(begin_event_id);
-        };
+        scope_threshold_guard const scope_guard(category_proxy, "longer_than_42us", threshold);
 
         clock_fixture::instance().advance(42us);
     }
@@ -545,14 +538,7 @@ BOOST_FIXTURE_TEST_CASE(threshold_test, proxy_fixture)
 
         // implementation of INTERNAL_TRACE_EVENT_ADD_SCOPED_IF_LONGER_THAN()
         static auto const category_proxy = category::get("threshold_test");
-        TraceEndOnScopeCloseThreshold scope_guard(category_proxy, "shorter_than_42us", threshold);
-
-        if (category_proxy) {
-            auto const begin_event_id =
-                AddTraceEvent(TraceEvent::phase::BEGIN, category_proxy.category_name(),
-                              "shorter_than_42us", 0, TraceEvent::flag::NONE);
-            scope_guard.set_threshold_begin_id(begin_event_id);
-        };
+        scope_threshold_guard const scope_guard(category_proxy, "shorter_than_42us", threshold);
 
         clock_fixture::instance().advance(40us);
     }
@@ -705,16 +691,8 @@ BOOST_FIXTURE_TEST_CASE(trace_macro_expansion, proxy_fixture)
         // ... expands to:
 #if 0
         static auto const __event_trace_uniq_category_proxy_542 = category::get("category_name");
-        TraceEndOnScopeCloseThreshold __event_trace_uniq_scope_guard_542(
-            __event_trace_uniq_category_proxy_542, "event_name", treshold);
-        if (__event_trace_uniq_category_proxy_542) {
-            std::int32_t __event_trace_uniq_begin_event_id_542 = AddTraceEvent(
-                TraceEvent::phase::BEGIN, __event_trace_uniq_category_proxy_542.category_name(),
-                "event_name", 0, TraceEvent::flag::NONE);
-            __event_trace_uniq_scope_guard_542.set_threshold_begin_id(
-                __event_trace_uniq_begin_event_id_542);
-        };
-
+        scope_threshold_guard const __event_trace_uniq_scope_guard_542(
+            __event_trace_uniq_category_proxy_542, "event_name", threshold);
 #endif
 
     }  // test scope end
@@ -15,6 +15,11 @@
 #include <iomanip>
 #include <limits>
 #include <iostream>
+#include <array>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <string>
 
 ///
 /// BOOST TEST requires that the types must be streamable, here we go ...
@@ -32,9 +37,8 @@ std::ostream& operator<<(std::ostream& os, std::pair<bool, bool> pair)
 BOOST_AUTO_TEST_SUITE(common_instrumentation_utils)
 
 //
-// The filter to select which category entries are allowed to log. The filter supports RE - for
-// detailed RE check, use [Regex101](https://regex101.com/) Here we test only the basic concept
-// since we trust in std::regex
+// The filter to select which category entries are allowed to log. The patterns match anywhere in
+// the category's name, the first match wins.
 //
 BOOST_AUTO_TEST_CASE(category_filter)
 {
@@ -50,6 +54,46 @@ BOOST_AUTO_TEST_CASE(category_filter)
     BOOST_TEST(filter.result_of("bar") == std::pair(true, false));
     BOOST_TEST(filter.result_of("bart") == std::pair(true, false));
     BOOST_TEST(filter.result_of("centibar") == std::pair(true, false));
+    BOOST_TEST(filter.result_of("baz") == std::pair(false, true));
+}
+
+//
+// The wildcard patterns of the filter, and the regular expressions on request.
+//
+BOOST_AUTO_TEST_CASE(category_filter_patterns)
+{
+    using ibis::tool::event_trace::category;
+
+    {
+        category::filter filter("^gui.*$, -^net, -io$, +^cache$");
+
+        BOOST_TEST(filter.result_of("gui.render") == std::pair(true, true));
+        BOOST_TEST(filter.result_of("my.gui.render") == std::pair(false, true));
+        BOOST_TEST(filter.result_of("network") == std::pair(true, false));
+        BOOST_TEST(filter.result_of("subnet") == std::pair(false, true));
+        BOOST_TEST(filter.result_of("disk.io") == std::pair(true, false));
+        BOOST_TEST(filter.result_of("io.disk") == std::pair(false, true));
+        BOOST_TEST(filter.result_of("cache") == std::pair(true, true));
+        BOOST_TEST(filter.result_of("caches") == std::pair(false, true));
+    }
+    {
+        category::filter filter("-^v?[0-9]*, ^[!a-c]x, a\\*b");
+
+        BOOST_TEST(filter.result_of("vm42") == std::pair(true, false));
+        BOOST_TEST(filter.result_of("vm") == std::pair(false, true));
+        BOOST_TEST(filter.result_of("dx") == std::pair(true, true));
+        BOOST_TEST(filter.result_of("bx") == std::pair(false, true));
+        BOOST_TEST(filter.result_of("xa*by") == std::pair(true, true));
+        BOOST_TEST(filter.result_of("xaby") == std::pair(false, true));
+    }
+    {
+        category::filter filter("-re:^ba(r|z)$, re:.");
+
+        BOOST_TEST(filter.count() == 2);
+        BOOST_TEST(filter.result_of("bar") == std::pair(true, false));
+        BOOST_TEST(filter.result_of("baz") == std::pair(true, false));
+        BOOST_TEST(filter.result_of("bay") == std::pair(true, true));
+    }
 }
 
 //
@@ -81,6 +125,15 @@ BOOST_AUTO_TEST_CASE(category_proxied_entries)
     BOOST_TEST(proxy_state("foo") == true);
     BOOST_TEST(proxy_state("bar") == false);
 
+    // the hash of the trace macros is computed at compile time, the same entry is found by it
+    {
+        namespace detail = ibis::tool::event_trace::detail;
+        static constexpr auto hash = detail::fnv1a("bar");
+        BOOST_TEST(category::get("bar", hash).category_name().data() ==
+                   category::get("bar").category_name().data());
+        BOOST_TEST(static_cast<bool>(category::get("bar", hash)) == false);
+    }
+
     // create a new category, enable state depend on category filter result
     BOOST_TEST(proxy_state("foo2") == true);
     BOOST_TEST(proxy_state("bar2") == true);
@@ -142,5 +195,105 @@ BOOST_AUTO_TEST_CASE(category_proxied_entries)
     }
 }
 
+//
+// Concurrent first-use registration of the same categories results into one entry each.
+//
+BOOST_AUTO_TEST_CASE(category_concurrent_registration)
+{
+    using ibis::tool::event_trace::category;
+
+    static constexpr std::size_t thread_count = 8;
+    static constexpr std::array<std::string_view, 4> names = {  // --
+        "concurrent_a", "concurrent_b", "concurrent_c", "concurrent_d"
+    };
+
+    auto const count_before = category::instance().GetKnownCategoriesCount();
+
+    std::atomic<std::size_t> mismatch_count = 0;  // Boost.Test isn't thread safe
+    std::vector<std::thread> threads;
+
+    for (std::size_t i = 0; i != thread_count; ++i) {
+        threads.emplace_back([&mismatch_count]() {
+            for (auto const name : names) {
+                if (category::get(name).category_name() != name) {
+                    ++mismatch_count;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    BOOST_TEST(mismatch_count == 0U);
+    BOOST_TEST(category::instance().GetKnownCategoriesCount() == count_before + names.size());
+}
+
+//
+// The categories can be switched on and off while other threads are tracing.
+//
+BOOST_AUTO_TEST_CASE(category_live_reconfiguration)
+{
+    using ibis::tool::event_trace::category;
+
+    auto const proxy = category::get("live_toggle");
+
+    std::atomic<bool> stop = false;
+    std::atomic<std::size_t> enabled_count = 0;
+
+    std::thread reader([&]() {
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (proxy) {
+                ++enabled_count;
+            }
+        }
+    });
+
+    for (std::size_t i = 0; i != 100; ++i) {
+        category::instance().SetEnabled((i % 2 == 0) ? "-live_toggle" : "live_toggle");
+    }
+    category::instance().SetEnabled("-live_toggle");
+
+    stop = true;
+    reader.join();
+
+    BOOST_TEST(proxy.enabled() == false);
+
+    category::instance().SetEnabled("live_toggle");
+    BOOST_TEST(proxy.enabled() == true);
+
+    category::instance().SetEnabled("");  // reset the filter for the following tests
+}
+
+//
+// There is no fixed limit of categories, proxies stay valid while the registry grows.
+//
+BOOST_AUTO_TEST_CASE(category_many_entries)
+{
+    using ibis::tool::event_trace::category;
+
+    static constexpr std::size_t category_count = 1000;
+
+    // category names must have application lifetime
+    static std::vector<std::string> const names = []() {
+        std::vector<std::string> names_;
+        for (std::size_t i = 0; i != category_count; ++i) {
+            names_.push_back("many_" + std::to_string(i));
+        }
+        return names_;
+    }();
+
+    auto const first = category::get(names.front());
+    auto const count_before = category::instance().GetKnownCategoriesCount();
+
+    for (auto const& name : names) {
+        BOOST_TEST(category::get(name).category_name() == name);
+    }
+
+    BOOST_TEST(category::instance().GetKnownCategoriesCount() ==
+               count_before + category_count - 1);
+    BOOST_TEST(first.category_name() == names.front());
+}
+
 // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
 BOOST_AUTO_TEST_SUITE_END()
@@ -9,6 +9,8 @@
 #include <boost/test/tools/output_test_stream.hpp>
 
 #include <iostream>
+#include <thread>
+#include <chrono>
 
 ///
 /// BOOST TEST requires that the types must be streamable, here we go ...
@@ -45,5 +47,37 @@ BOOST_AUTO_TEST_CASE(mock_clock)
     std::cout << clock::now() << '\n';
 }
 
+BOOST_AUTO_TEST_CASE(tsc_clock)
+{
+    using namespace std::chrono_literals;
+    using ibis::tool::event_trace::clock::clock_type;
+    using clock = ibis::tool::event_trace::clock::time<ibis::tool::event_trace::clock::tsc_clock>;
+
+    // the converted tick intervals are the steady clock's durations, within calibration's
+    // accuracy; the time points may drift apart with the time since calibration. The ticks'
+    // interval is enclosed by an outer and encloses an inner interval of the steady clock.
+    auto const outer_begin = clock_type::now();
+    auto const ticks_begin = clock::ticks();
+    auto const inner_begin = clock_type::now();
+    std::this_thread::sleep_for(20ms);
+    auto const inner_end = clock_type::now();
+    auto const ticks_end = clock::ticks();
+    auto const outer_end = clock_type::now();
+
+    BOOST_TEST(ticks_begin <= ticks_end);
+
+    using nanoseconds = std::chrono::duration<double, std::nano>;
+    constexpr double tolerance = 0.05;  // relative
+
+    auto const tsc_ns = nanoseconds(clock::to_duration(ticks_end - ticks_begin)).count();
+    BOOST_TEST(tsc_ns >= nanoseconds(inner_end - inner_begin).count() * (1.0 - tolerance));
+    BOOST_TEST(tsc_ns <= nanoseconds(outer_end - outer_begin).count() * (1.0 + tolerance));
+
+    // round trip of durations
+    auto const ticks_1ms = clock::to_ticks(1ms);
+    auto const dur = clock::to_duration(ticks_1ms);
+    BOOST_TEST((dur - 1ms < 1us && 1ms - dur < 1us));
+}
+
 // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,74 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+// compile out the categories below for this translation unit only
+#define IBIS_TRACE_DISABLED_CATEGORIES "compiled_out, compiled_out_prefix.*"
+
+#include <ibis/event_trace/event_trace.hpp>
+
+#include <testsuite/namespace_alias.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+
+BOOST_AUTO_TEST_SUITE(common_instrumentation_utils)
+
+//
+// The compile time list of disabled categories
+//
+BOOST_AUTO_TEST_CASE(category_list)
+{
+    using ibis::tool::event_trace::detail::category_listed;
+
+    static_assert(category_listed("foo, bar", "foo"));
+    static_assert(category_listed("foo, bar", "bar"));
+    static_assert(!category_listed("foo, bar", "foobar"));
+    static_assert(!category_listed("foo, bar", "fo"));
+    static_assert(category_listed(" gui.* ,foo", "gui.render"));
+    static_assert(category_listed("gui*", "gui"));
+    static_assert(!category_listed("gui.*", "gui"));
+    static_assert(!category_listed("", "foo"));
+    static_assert(!category_listed(",,", ""));
+
+    BOOST_TEST(category_listed("foo, bar", "bar") == true);
+}
+
+//
+// Trace macros of disabled categories compile to nothing, not even the category is registered.
+//
+BOOST_AUTO_TEST_CASE(disabled_category)
+{
+    using namespace ::ibis::tool::event_trace;
+
+    bool evaluated = false;
+    auto const side_effect = [&evaluated]() {
+        evaluated = true;
+        return 42;
+    };
+
+    {
+        TRACE_EVENT0("compiled_out", "scope");
+        TRACE_EVENT1("compiled_out_prefix.scope", "scope", "value", side_effect());
+        TRACE_EVENT_IF_LONGER_THAN0(0, "compiled_out", "threshold scope");
+        TRACE_EVENT_INSTANT1("compiled_out_prefix.instant", "instant", "value", side_effect());
+        TRACE_COUNTER_ID1("compiled_out", "counter", 42, side_effect());
+        TRACE_EVENT_INSTANT0("compiled_in", "instant");
+    }
+
+    auto const known = [](std::string_view category_name) {
+        auto const categories = category::instance().GetKnownCategories();
+        return std::find(categories.begin(), categories.end(), category_name) != categories.end();
+    };
+
+    BOOST_TEST(evaluated == false);
+    BOOST_TEST(known("compiled_out") == false);
+    BOOST_TEST(known("compiled_out_prefix.scope") == false);
+    BOOST_TEST(known("compiled_out_prefix.instant") == false);
+    BOOST_TEST(known("compiled_in") == true);
+}
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,115 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <ibis/event_trace/detail/json_writer.hpp>
+
+#include <testsuite/namespace_alias.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(common_instrumentation_utils)
+
+BOOST_AUTO_TEST_CASE(json_writer_numbers)
+{
+    using ibis::tool::event_trace::detail::json_writer;
+
+    auto const as_json = [](auto value) {
+        std::string out;
+        json_writer(out).number(value);
+        return out;
+    };
+
+    BOOST_TEST(as_json(0) == "0");
+    BOOST_TEST(as_json(-42) == "-42");
+    BOOST_TEST(as_json(std::numeric_limits<std::int64_t>::min()) == "-9223372036854775808");
+    BOOST_TEST(as_json(std::numeric_limits<std::uint64_t>::max()) == "18446744073709551615");
+    BOOST_TEST(as_json(2.5) == "2.5");
+    BOOST_TEST(as_json(0.1) == "0.1");
+    BOOST_TEST(as_json(std::numeric_limits<double>::infinity()) == "null");
+    BOOST_TEST(as_json(std::numeric_limits<double>::quiet_NaN()) == "null");
+
+    std::string out;
+    json_writer(out).hex_string(42, 8, true);
+    BOOST_TEST(out == R"("0x0000002A")");
+}
+
+BOOST_AUTO_TEST_CASE(json_writer_strings)
+{
+    using ibis::tool::event_trace::detail::json_writer;
+    using ibis::tool::event_trace::trace_value;
+
+    auto const as_json = [](auto value) {
+        std::string out;
+        json_writer(out).value(trace_value(value));
+        return out;
+    };
+
+    BOOST_TEST(as_json("plain") == R"("plain")");
+    BOOST_TEST(as_json("a \"quoted\" \\ path/") == R"("a \"quoted\" \\ path/")");
+    BOOST_TEST(as_json("tab\tnew line\n") == R"("tab\tnew line\n")");
+    BOOST_TEST(as_json("\x01""bell\x07") == R"("\u0001bell\u0007")");
+    BOOST_TEST(as_json(true) == "true");
+    BOOST_TEST(as_json(static_cast<char const*>(nullptr)) == "null");
+    BOOST_TEST(as_json(trace_value()) == "null");
+}
+
+//
+// The escaping scans blocks of characters vectorized, check the characters to be escaped at all
+// positions of the blocks and the remainder.
+//
+BOOST_AUTO_TEST_CASE(json_writer_escape_positions)
+{
+    using ibis::tool::event_trace::detail::json_writer;
+
+    for (std::size_t length = 1; length != 80; ++length) {
+        for (std::size_t pos = 0; pos != length; ++pos) {
+            for (char const chr : { '"', '\\', '\n', '\x1F' }) {
+                std::string str(length, 'x');
+                str[pos] = chr;
+
+                std::string out;
+                json_writer(out).escaped(str);
+
+                auto const escape_sz = (chr == '\x1F') ? 6U : 2U;  // "\u001F" or e.g. "\n"
+                BOOST_TEST_REQUIRE(out.size() == length - 1 + escape_sz);
+                BOOST_TEST_REQUIRE(out.find_first_not_of('x') == pos);
+            }
+        }
+    }
+
+    // none of the characters >= 0x80 (UTF-8 sequences) is escaped
+    std::string const utf8 = "gr\xC3\xBC\xC3\x9F Gott, \xE2\x82\xAC 42 and some more text";
+    std::string out;
+    json_writer(out).escaped(utf8);
+    BOOST_TEST(out == utf8);
+}
+
+BOOST_AUTO_TEST_CASE(json_writer_escape_sink)
+{
+    using ibis::tool::event_trace::detail::json_writer;
+
+    // same escaping as by the writer, e.g. for an output iterator
+    std::string const str = "a \"quoted\" \\ path/\ttab\x01";
+
+    std::string expected;
+    json_writer(expected).escaped(str);
+
+    std::vector<char> out;
+    json_writer::escape(str, [&out](std::string_view run) {
+        std::copy(run.begin(), run.end(), std::back_inserter(out));
+    });
+
+    BOOST_TEST(std::string(out.begin(), out.end()) == expected);
+    BOOST_TEST(expected == R"(a \"quoted\" \\ path/\ttab\u0001)");
+}
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+BOOST_AUTO_TEST_SUITE_END()
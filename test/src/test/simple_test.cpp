@@ -7,6 +7,7 @@
 #include <ibis/event_trace/trace_event.hpp>
 #include <ibis/event_trace/scoped_event.hpp>
 #include <ibis/event_trace/event_trace.hpp>
+#include <ibis/event_trace/binary_trace.hpp>
 
 #include <testsuite/mock_clock.hpp>
 #include <testsuite/namespace_alias.hpp>
@@ -14,6 +15,23 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/test/tools/output_test_stream.hpp>
 
+#include <sstream>
+#include <string>
+#include <thread>
+#include <future>
+#include <mutex>
+#include <chrono>
+#include <atomic>
+#include <vector>
+#include <array>
+#include <cstddef>
+#include <new>
+
+#if defined(IBIS_BUILD_PLATFORM_LINUX)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 namespace testsuite {
 
 ///
@@ -46,6 +64,30 @@ struct callback_fixture {
         return ots->str();
     }
 
+    /// Number of occurrences of @a pattern in @a str, e.g. a part of result_str().
+    static std::size_t occurrences(std::string_view str, std::string_view pattern)
+    {
+        std::size_t count = 0;
+        for (auto pos = str.find(pattern); pos != std::string_view::npos;
+             pos = str.find(pattern, pos + 1)) {
+            ++count;
+        }
+        return count;
+    }
+
+    /// The JSON of an event's time stamp at clock @a ticks followed by the event's @a name.
+    static std::string json_ts_name(ibis::tool::event_trace::clock::tick_type ticks,
+                                    std::string_view name)
+    {
+        namespace clock = ibis::tool::event_trace::clock;
+
+        auto const time_ns = std::chrono::time_point_cast<std::chrono::nanoseconds>(
+                                 clock::time<>::to_time_point(ticks))
+                                 .time_since_epoch()
+                                 .count();
+        return R"("ts":)" + std::to_string(time_ns) + R"(,"name":")" + std::string(name) + '"';
+    }
+
 private:
     static inline std::unique_ptr<btt::output_test_stream> ots = nullptr;
 };
@@ -125,5 +167,773 @@ BOOST_FIXTURE_TEST_CASE(simple_trace, testcase_fixture)
     std::cout << "\nResult:\n" << result_str() << "\n";
 }
 
+//
+// Flight recorder mode keeps only the latest events, the oldest are overwritten.
+//
+BOOST_FIXTURE_TEST_CASE(ring_buffer_trace, testcase_fixture)
+{
+    namespace event_trace = ::ibis::tool::event_trace;
+    using event_trace::TraceLog;
+    using event_trace::TraceEvent;
+    using event_trace::event_chunk;
+
+    static constexpr std::size_t event_count = 2 * event_chunk::CHUNK_SZ;
+    static constexpr std::int64_t last_event = 5 * event_chunk::CHUNK_SZ - 1;
+
+    auto& trace_log = TraceLog::GetInstance();
+
+    trace_log.Flush();
+    trace_log.SetBufferMode(TraceLog::buffer_mode::RING, event_count);
+
+    for (std::int64_t i = 0; i <= last_event; ++i) {
+        AddTraceEvent(TraceEvent::phase::INSTANT,  // --
+                      "ring_buffer", "instant",     // --
+                      0, TraceEvent::flag::NONE,   // --
+                      "count", i);
+    }
+
+    BOOST_TEST(trace_log.GetEventsCount() <= event_count);
+
+    trace_log.Flush();
+    trace_log.SetBufferMode(TraceLog::buffer_mode::FILL);
+
+    auto const contains = [&](std::int64_t count) {
+        return result_str().find(R"("args":{"count":)" + std::to_string(count) + "}") !=
+               std::string::npos;
+    };
+
+    BOOST_TEST(contains(last_event) == true);
+    BOOST_TEST(contains(last_event - event_chunk::CHUNK_SZ) == true);
+    BOOST_TEST(contains(0) == false);
+}
+
+//
+// The flight recorder's time window keeps the recent events, also if the chunk's last event is an
+// old one (e.g. stamped explicitly).
+//
+BOOST_FIXTURE_TEST_CASE(ring_buffer_time_window, testcase_fixture)
+{
+    namespace event_trace = ::ibis::tool::event_trace;
+    using event_trace::TraceLog;
+    using event_trace::TraceEvent;
+    using event_trace::TraceID;
+    namespace clock = event_trace::clock;
+
+    using namespace std::chrono_literals;
+
+    auto& trace_log = TraceLog::GetInstance();
+
+    trace_log.Flush();
+    trace_log.SetBufferMode(TraceLog::buffer_mode::RING, 4 * event_trace::event_chunk::CHUNK_SZ,
+                            10s);
+
+    auto const now = clock::time<>::ticks();
+    auto const old = now - clock::time<>::to_ticks(60s);
+
+    auto const begin = result_str().size();
+    trace_log.AddTraceEvent(TraceEvent::phase::INSTANT, "time_window", "old",  // --
+                            TraceID::NONE, TraceEvent::flag::NONE, old, 0);
+    trace_log.AddTraceEvent(TraceEvent::phase::INSTANT, "time_window", "recent",  // --
+                            TraceID::NONE, TraceEvent::flag::NONE, now, 0);
+    trace_log.AddTraceEvent(TraceEvent::phase::COMPLETE, "time_window", "old_complete",
+                            TraceID::NONE, TraceEvent::flag::NONE, old + 1, 1);
+
+    trace_log.Flush();
+    trace_log.SetBufferMode(TraceLog::buffer_mode::FILL);
+
+    auto const trace = result_str().substr(begin);
+
+    BOOST_TEST(trace.find(R"("name":"recent")") != std::string::npos);
+    BOOST_TEST(trace.find(R"("name":"old")") == std::string::npos);
+    BOOST_TEST(trace.find(R"("name":"old_complete")") == std::string::npos);
+}
+
+//
+// Flush() collects the events published by all threads, also of the ones being blocked. The events
+// flushed are skipped when the thread hands over its chunk afterwards.
+//
+BOOST_FIXTURE_TEST_CASE(blocked_thread_trace, testcase_fixture)
+{
+    namespace event_trace = ::ibis::tool::event_trace;
+    using event_trace::TraceLog;
+    using event_trace::TraceEvent;
+
+    auto& trace_log = TraceLog::GetInstance();
+
+    trace_log.Flush();
+
+    std::promise<void> recorded;
+    std::promise<void> release;
+
+    auto worker = std::thread([&]() {
+        AddTraceEvent(TraceEvent::phase::INSTANT,      // --
+                      "blocked_thread", "instant",     // --
+                      0, TraceEvent::flag::NONE,       // --
+                      "count", 1);
+        recorded.set_value();
+        release.get_future().wait();
+        AddTraceEvent(TraceEvent::phase::INSTANT,      // --
+                      "blocked_thread", "instant",     // --
+                      0, TraceEvent::flag::NONE,       // --
+                      "count", 2);
+    });
+
+    recorded.get_future().wait();
+
+    auto const begin = result_str().size();
+    trace_log.Flush();
+    auto const blocked = result_str().substr(begin);
+
+    release.set_value();
+    worker.join();
+
+    trace_log.Flush();
+    auto const all = result_str().substr(begin);
+
+    auto const arg = [](int value) { return R"("args":{"count":)" + std::to_string(value) + "}"; };
+
+    BOOST_TEST(occurrences(blocked, arg(1)) == 1U);
+    BOOST_TEST(occurrences(blocked, arg(2)) == 0U);
+    BOOST_TEST(occurrences(all, arg(1)) == 1U);
+    BOOST_TEST(occurrences(all, arg(2)) == 1U);
+}
+
+//
+// The background flusher is woken up by the buffer's fill level and by its interval.
+//
+BOOST_FIXTURE_TEST_CASE(background_flusher_trace, testcase_fixture)
+{
+    namespace event_trace = ::ibis::tool::event_trace;
+    using event_trace::TraceLog;
+    using event_trace::TraceEvent;
+    using event_trace::event_chunk;
+
+    using namespace std::chrono_literals;
+
+    auto& trace_log = TraceLog::GetInstance();
+
+    trace_log.Flush();
+
+    // the flusher's output is written by another thread
+    std::mutex mutex;
+    std::string output;
+    trace_log.setOutputCallback([&](std::string_view sv) {
+        std::scoped_lock scoped_lock(mutex);
+        output += sv;
+    });
+
+    auto const wait_for = [&](std::string_view str) {
+        auto const timeout = std::chrono::steady_clock::now() + 10s;
+        while (std::chrono::steady_clock::now() < timeout) {
+            {
+                std::scoped_lock scoped_lock(mutex);
+                if (output.find(str) != std::string::npos) {
+                    return true;
+                }
+            }
+            std::this_thread::sleep_for(1ms);
+        }
+        return false;
+    };
+
+    auto const record = [](std::string_view event_name, std::size_t count) {
+        for (std::size_t i = 0; i != count; ++i) {
+            AddTraceEvent(TraceEvent::phase::INSTANT,                         // --
+                          "background_flusher", event_name,                  // --
+                          0, TraceEvent::flag::NONE,                          // --
+                          "count", static_cast<std::uint64_t>(i));
+        }
+    };
+
+    // 2 of 8 chunks handed over reach the fill level, there is no interval
+    trace_log.SetBufferMode(TraceLog::buffer_mode::FILL, 8 * event_chunk::CHUNK_SZ);
+    trace_log.StartFlusher(0.25F, event_trace::clock::duration_zero);
+
+    record("fill_level", 2 * event_chunk::CHUNK_SZ + 1);  // the 3rd chunk hands over the 2nd
+    BOOST_TEST(wait_for(R"("name":"fill_level","args":{"count":)" +
+                        std::to_string(2 * event_chunk::CHUNK_SZ - 1) + "}"));
+
+    trace_log.StopFlusher();
+
+    // the fill level isn't reached, the interval flushes the events still recorded
+    trace_log.StartFlusher(1.0F, 10ms);
+
+    record("interval", 1);
+    BOOST_TEST(wait_for(R"("name":"interval")"));
+
+    trace_log.StopFlusher();
+    BOOST_TEST(trace_log.IsFlusherRunning() == false);
+
+    trace_log.SetBufferMode(TraceLog::buffer_mode::FILL);
+    trace_log.setOutputCallback(
+        [](std::string_view sv) { testsuite::callback_fixture::instance().output(sv); });
+}
+
+//
+// Threads register concurrently, the records of exited threads are reused after their events
+// are flushed. Hence short-lived threads don't grow the thread name metadata.
+//
+BOOST_FIXTURE_TEST_CASE(thread_registry_reuse, testcase_fixture)
+{
+    namespace event_trace = ::ibis::tool::event_trace;
+    using event_trace::TraceLog;
+    using event_trace::TraceEvent;
+
+    static constexpr std::size_t thread_count = 8;
+    static constexpr std::size_t wave_count = 10;
+
+    auto& trace_log = TraceLog::GetInstance();
+
+    trace_log.Flush();
+
+    auto const begin = result_str().size();
+
+    for (std::size_t wave = 0; wave != wave_count; ++wave) {
+        std::atomic<bool> start = false;
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i != thread_count; ++i) {
+            threads.emplace_back([&start]() {
+                while (!start.load()) {
+                    std::this_thread::yield();
+                }
+                AddTraceEvent(TraceEvent::phase::INSTANT,           // --
+                              "thread_registry", "short_lived",     // --
+                              0, TraceEvent::flag::NONE);
+            });
+        }
+        start.store(true);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        trace_log.Flush();
+    }
+
+    auto const events = result_str().substr(begin);
+
+    trace_log.AddThreadNameMetadataEvents();
+    trace_log.Flush();
+
+    auto const metadata = result_str().substr(begin + events.size());
+
+    BOOST_TEST(occurrences(events, R"("name":"short_lived")") == thread_count * wave_count);
+    BOOST_TEST(occurrences(metadata, R"("name":"thread_name")") <= thread_count);
+}
+
+#if defined(IBIS_BUILD_PLATFORM_LINUX)
+//
+// The events carry the kernel's thread ID, the registry's records are indexed densely.
+//
+BOOST_FIXTURE_TEST_CASE(thread_id_trace, testcase_fixture)
+{
+    namespace event_trace = ::ibis::tool::event_trace;
+    using event_trace::TraceLog;
+    using event_trace::TraceEvent;
+    using event_trace::thread_registry;
+
+    auto& trace_log = TraceLog::GetInstance();
+
+    trace_log.Flush();
+    auto const begin = result_str().size();
+
+    auto worker_tid = pid_t{ 0 };
+    std::thread([&worker_tid]() {
+        worker_tid = static_cast<pid_t>(syscall(SYS_gettid));
+        AddTraceEvent(TraceEvent::phase::INSTANT,  // --
+                      "thread_id", "worker",       // --
+                      0, TraceEvent::flag::NONE);
+    }).join();
+
+    trace_log.Flush();
+
+    auto const trace = result_str().substr(begin);
+    auto const event_pos = trace.find(R"("name":"worker")");
+    BOOST_REQUIRE(event_pos != std::string::npos);
+
+    auto const event_begin = trace.rfind('{', event_pos);
+    auto const event = trace.substr(event_begin, event_pos - event_begin);
+
+    BOOST_TEST(worker_tid != getpid());
+    BOOST_TEST(event.find(R"("tid":)" + std::to_string(worker_tid) + ",") != std::string::npos);
+
+    // A registry of its own, the threads aren't registered by TraceLog. The records aren't
+    // released, hence each thread gets the next index.
+    thread_registry registry;
+    std::vector<thread_registry::index_type> indices;
+    std::vector<pid_t> tids;
+    for (std::size_t i = 0; i != 4; ++i) {
+        std::thread([&]() {
+            auto const& record = registry.current();
+            indices.push_back(record.index);
+            tids.push_back(static_cast<pid_t>(syscall(SYS_gettid)));
+        }).join();
+    }
+
+    BOOST_TEST(indices == (std::vector<thread_registry::index_type>{ 0, 1, 2, 3 }),
+               btt::per_element());
+    for (std::size_t i = 0; i != indices.size(); ++i) {
+        BOOST_TEST(registry[indices[i]].thread_id == tids[i]);
+    }
+}
+#endif
+
+//
+// The parallel flush writes the same output as the serial one.
+//
+BOOST_FIXTURE_TEST_CASE(parallel_flush_trace, testcase_fixture)
+{
+    namespace event_trace = ::ibis::tool::event_trace;
+    using event_trace::TraceLog;
+    using event_trace::TraceEvent;
+    using event_trace::TraceID;
+    using event_trace::event_chunk;
+    namespace clock = event_trace::clock;
+
+    static constexpr std::int64_t event_count = 5 * event_chunk::CHUNK_SZ + 42;
+
+    auto& trace_log = TraceLog::GetInstance();
+
+    auto const base = clock::time<>::ticks();
+    auto const record_and_flush = [&]() {
+        auto const begin = result_str().size();
+        for (std::int64_t i = 0; i != event_count; ++i) {
+            trace_log.AddTraceEvent(TraceEvent::phase::INSTANT,  // --
+                                    "parallel_flush", "instant",  // --
+                                    TraceID::NONE, TraceEvent::flag::NONE,  // --
+                                    base + static_cast<clock::tick_type>(i), 0, "count", i);
+        }
+        trace_log.Flush();
+        return result_str().substr(begin);
+    };
+
+    trace_log.Flush();
+
+    auto const serial = record_and_flush();
+    trace_log.SetFlushThreads(4);
+    auto const parallel = record_and_flush();
+    trace_log.SetFlushThreads(0);
+
+    BOOST_TEST(serial.find(R"("args":{"count":)" + std::to_string(event_count - 1) + "}") !=
+               std::string::npos);
+    BOOST_TEST(serial == parallel);
+}
+
+//
+// The binary format converted to JSON is the same as written as JSON.
+//
+BOOST_FIXTURE_TEST_CASE(binary_trace, testcase_fixture)
+{
+    namespace event_trace = ::ibis::tool::event_trace;
+    using event_trace::TraceLog;
+    using event_trace::TraceEvent;
+    using event_trace::TraceID;
+    namespace clock = event_trace::clock;
+
+    auto& trace_log = TraceLog::GetInstance();
+
+    auto const base = clock::time<>::ticks();
+    auto const trace_session = [&](TraceLog::output_format format) {
+        auto const begin = result_str().size();
+        trace_log.SetOutputFormat(format);
+        trace_log.BeginLogging();
+        for (std::int64_t i = 0; i != 3000; ++i) {
+            auto const time = base + static_cast<clock::tick_type>(i * 1000);
+            trace_log.AddTraceEvent(TraceEvent::phase::INSTANT, "binary \"trace\"", "instant",
+                                    TraceID::NONE, TraceEvent::flag::NONE, time, 0,  // --
+                                    "int", -i, "double", 0.1 * static_cast<double>(i));
+            trace_log.AddTraceEvent(TraceEvent::phase::COMPLETE, "binary", TraceLog::copy("complete"),
+                                    TraceID::NONE, TraceEvent::flag::NONE, time - 500, 250,  // --
+                                    "str", "text\n", "bool", (i % 2) == 0);
+            trace_log.AddTraceEvent(TraceEvent::phase::ASYNC_BEGIN, "binary", "async",  // --
+                                    static_cast<std::uint64_t>(i), TraceEvent::flag::HAS_ID,
+                                    time, 0, "ptr", static_cast<void const*>(&trace_log),
+                                    "null", static_cast<char const*>(nullptr));
+        }
+        trace_log.Flush();
+        trace_log.EndLogging();
+        trace_log.SetOutputFormat(TraceLog::output_format::JSON);
+        return result_str().substr(begin);
+    };
+
+    auto const json = trace_session(TraceLog::output_format::JSON);
+    auto const binary = trace_session(TraceLog::output_format::BINARY);
+
+    std::istringstream input(binary);
+    std::ostringstream output;
+    event_trace::binary_to_json(input, output);
+
+    BOOST_TEST(binary.size() * 3 < json.size());
+    BOOST_TEST(output.str() == json);
+
+    std::istringstream truncated(binary.substr(0, binary.size() - 2));  // mid of last event
+    std::ostringstream ignored;
+    BOOST_CHECK_THROW(event_trace::binary_to_json(truncated, ignored), std::runtime_error);
+}
+
+//
+// The Perfetto trace is a sequence of TracePacket messages, the names are interned once.
+//
+BOOST_FIXTURE_TEST_CASE(perfetto_trace, testcase_fixture)
+{
+    namespace event_trace = ::ibis::tool::event_trace;
+    using event_trace::TraceLog;
+    using event_trace::TraceEvent;
+    using event_trace::TraceID;
+    namespace clock = event_trace::clock;
+
+    auto& trace_log = TraceLog::GetInstance();
+
+    auto const begin = result_str().size();
+    trace_log.SetOutputFormat(TraceLog::output_format::PERFETTO);
+    trace_log.BeginLogging();
+
+    auto const base = clock::time<>::ticks();
+    for (std::int64_t i = 0; i != 100; ++i) {
+        auto const time = base + static_cast<clock::tick_type>(i * 1000);
+        trace_log.AddTraceEvent(TraceEvent::phase::BEGIN, "perfetto", "perfetto_slice",  // --
+                                TraceID::NONE, TraceEvent::flag::NONE, time, 0, "int", -i);
+        trace_log.AddTraceEvent(TraceEvent::phase::END, "perfetto", "perfetto_slice",  // --
+                                TraceID::NONE, TraceEvent::flag::NONE, time + 100, 0);
+        trace_log.AddTraceEvent(TraceEvent::phase::COMPLETE, "perfetto", "perfetto_complete",
+                                TraceID::NONE, TraceEvent::flag::NONE, time + 200, 250,  // --
+                                "str", "text", "null", static_cast<char const*>(nullptr));
+        trace_log.AddTraceEvent(TraceEvent::phase::INSTANT, "perfetto", "perfetto_instant",
+                                TraceID::NONE, TraceEvent::flag::NONE, time + 500, 0,  // --
+                                "double", 0.5, "bool", true);
+        trace_log.AddTraceEvent(TraceEvent::phase::COUNTER, "perfetto", "perfetto_counter",
+                                TraceID::NONE, TraceEvent::flag::NONE, time + 600, 0,  // --
+                                "value", i);
+        trace_log.AddTraceEvent(TraceEvent::phase::ASYNC_BEGIN, "perfetto", "perfetto_async",
+                                static_cast<std::uint64_t>(i % 2), TraceEvent::flag::HAS_ID,
+                                time + 700, 0);
+        trace_log.AddTraceEvent(TraceEvent::phase::ASYNC_END, "perfetto", "perfetto_async",
+                                static_cast<std::uint64_t>(i % 2), TraceEvent::flag::HAS_ID,
+                                time + 800, 0);
+    }
+
+    trace_log.Flush();
+    trace_log.EndLogging();
+    trace_log.SetOutputFormat(TraceLog::output_format::JSON);
+
+    auto const trace = result_str().substr(begin);
+
+    // interned on first use
+    BOOST_TEST(occurrences(trace, "perfetto_slice") == 1U);
+    BOOST_TEST(occurrences(trace, "perfetto_complete") == 1U);
+    BOOST_TEST(occurrences(trace, "perfetto_async") == 1U + 2U);  // name and the 2 async tracks
+    BOOST_TEST(occurrences(trace, "perfetto_counter value") == 1U);  // the counter track's name
+    BOOST_TEST(occurrences(trace, "text") == 100U);
+
+    // the fields of the messages must be consistent down to the trace's end
+    auto pos = std::size_t{ 0 };
+    auto const varint = [&]() {
+        std::uint64_t value = 0;
+        for (unsigned shift = 0; pos != trace.size() && shift < 64; shift += 7) {
+            auto const byte = static_cast<std::uint8_t>(trace[pos++]);
+            value |= std::uint64_t{ byte & 0x7FU } << shift;
+            if ((byte & 0x80U) == 0) {
+                return value;
+            }
+        }
+        throw std::runtime_error("truncated varint");
+    };
+
+    std::size_t packets = 0;
+    while (pos != trace.size()) {
+        BOOST_REQUIRE(varint() == ((1U << 3U) | 2U));  // Trace.packet, length delimited
+        auto const packet_end = pos + varint();
+        BOOST_REQUIRE(packet_end <= trace.size());
+        while (pos < packet_end) {
+            switch (varint() & 0x7U) {
+                case 0:
+                    varint();
+                    break;
+                case 1:
+                    pos += 8;
+                    break;
+                case 2:
+                    pos += varint();
+                    break;
+                default:
+                    BOOST_FAIL("unexpected wire type");
+            }
+        }
+        BOOST_REQUIRE(pos == packet_end);
+        ++packets;
+    }
+
+    // 8 track events for each iteration, the complete one is split into begin and end
+    BOOST_TEST(packets > 8U * 100U);
+}
+
+//
+// Threshold scopes record a single complete event, but only if the scope lasts long enough.
+//
+BOOST_FIXTURE_TEST_CASE(threshold_trace, testcase_fixture)
+{
+    namespace event_trace = ::ibis::tool::event_trace;
+    using event_trace::TraceLog;
+    using event_trace::category;
+    using event_trace::scope_threshold_guard;
+
+    using namespace std::chrono_literals;
+
+    TraceLog::GetInstance().BeginLogging();
+
+    {
+        static auto const category_enabled = category::get("threshold_scope");
+        auto const scope = scope_threshold_guard(category_enabled, "short scope", 1h);
+    }  // test scope end
+
+    {
+        static auto const category_enabled = category::get("threshold_scope");
+        auto const scope = scope_threshold_guard(category_enabled, "long scope", 0ns,  // --
+                                                 "compile file", "ibis.cpp");
+    }  // test scope end
+
+    {
+        // the copied string's temporary is gone at the end of scope
+        static auto const category_enabled = category::get("threshold_scope");
+        auto const scope = scope_threshold_guard(category_enabled, "copy scope", 0ns, "file",
+                                                 TraceLog::copy(std::string(64, 'c') + ".cpp"));
+    }  // test scope end
+
+    TraceLog::GetInstance().Flush();
+    TraceLog::GetInstance().EndLogging();
+
+    auto const contains = [&](std::string_view str) {
+        return result_str().find(str) != std::string::npos;
+    };
+
+    BOOST_TEST(contains("short scope") == false);
+    BOOST_TEST(contains(R"("ph":"X")") == true);
+    BOOST_TEST(contains(R"("name":"long scope","args":{"compile file":"ibis.cpp"},"dur":)") == true);
+    BOOST_TEST(contains(R"("name":"copy scope","args":{"file":")" + std::string(64, 'c') +
+                        R"(.cpp"},"dur":)") == true);
+}
+
+//
+// Scoped events are recorded as single complete event with duration.
+//
+BOOST_FIXTURE_TEST_CASE(complete_scope_trace, testcase_fixture)
+{
+    using namespace ::ibis::tool::event_trace;
+
+    TraceLog::GetInstance().BeginLogging();
+
+    {
+        TRACE_EVENT1("complete_scope", "compile", "compile file", "ibis.cpp");
+    }  // test scope end
+
+    for (std::size_t i = 0; i != 4; ++i) {
+        // the copied string's temporary is gone at the end of scope
+        TRACE_EVENT1("complete_scope", "step", "step name",
+                     TraceLog::copy("step " + std::to_string(i) + std::string(32, '.')));
+    }  // test scope end
+
+    TraceLog::GetInstance().Flush();
+    TraceLog::GetInstance().EndLogging();
+
+    auto const contains = [&](std::string_view str) {
+        return result_str().find(str) != std::string::npos;
+    };
+
+#if IBIS_TRACE_EVENT_COMPLETE_SCOPES
+    BOOST_TEST(contains(R"("ph":"X")") == true);
+    BOOST_TEST(contains(R"("ph":"B")") == false);
+    BOOST_TEST(contains(R"("name":"compile","args":{"compile file":"ibis.cpp"},"dur":)") == true);
+    for (std::size_t i = 0; i != 4; ++i) {
+        BOOST_TEST(contains(R"("args":{"step name":"step )" + std::to_string(i) +
+                            std::string(32, '.') + R"("})") == true);
+    }
+#else
+    BOOST_TEST(contains(R"("ph":"B")") == true);
+    BOOST_TEST(contains(R"("ph":"E")") == true);
+#endif
+}
+
+//
+// Events with more than one argument, also with copied strings.
+//
+BOOST_FIXTURE_TEST_CASE(multiple_args_trace, testcase_fixture)
+{
+    using namespace ::ibis::tool::event_trace;
+
+    TraceLog::GetInstance().BeginLogging();
+
+    {
+        std::string const file_name = "ibis.cpp";
+
+        TRACE_EVENT_INSTANT2("multiple_args", "compile", "compile file", TraceLog::copy(file_name),
+                             "line", 42);
+        TRACE_COUNTER2("multiple_args", "memory", "heap", 1024, "stack", 64);
+
+        AddTraceEvent(TraceEvent::phase::INSTANT,                  // --
+                      "multiple_args", TraceLog::copy(file_name),  // --
+                      0, TraceEvent::flag::NONE,                   // --
+                      "a", 1, "b", 2.5, "c", true, TraceLog::copy("d"), "four");
+    }  // test scope end
+
+    TraceLog::GetInstance().Flush();
+    TraceLog::GetInstance().EndLogging();
+
+    auto const contains = [&](std::string_view str) {
+        return result_str().find(str) != std::string::npos;
+    };
+
+    BOOST_TEST(contains(R"("name":"compile","args":{"compile file":"ibis.cpp","line":42})") == true);
+    BOOST_TEST(contains(R"("name":"memory","args":{"heap":1024,"stack":64})") == true);
+    BOOST_TEST(contains(R"("name":"ibis.cpp","args":{"a":1,"b":2.5,"c":true,"d":"four"})") == true);
+}
+
+//
+// The events store their time stamps relative to the chunk's base time, events out of the 32-bit
+// delta range store their full time stamp.
+//
+BOOST_FIXTURE_TEST_CASE(time_delta_trace, testcase_fixture)
+{
+    using namespace ::ibis::tool::event_trace;
+
+    auto& trace_log = TraceLog::GetInstance();
+
+    trace_log.BeginLogging();
+
+    auto const base = clock::time<>::ticks();
+    auto const far = base + (clock::tick_type{ 1 } << 33U);  // beyond delta range
+    auto const before = base - 1000;                         // before the chunk's base time
+
+    trace_log.AddTraceEvent(TraceEvent::phase::INSTANT, "time_delta", "base",  // --
+                            TraceID::NONE, TraceEvent::flag::NONE, base, 0);
+    trace_log.AddTraceEvent(TraceEvent::phase::INSTANT, "time_delta", "far",  // --
+                            TraceID::NONE, TraceEvent::flag::NONE, far, 0);
+    trace_log.AddTraceEvent(TraceEvent::phase::COMPLETE, "time_delta", "before",  // --
+                            TraceID::NONE, TraceEvent::flag::NONE, before, 1000);
+
+    trace_log.Flush();
+    trace_log.EndLogging();
+
+    auto const trace = result_str();
+
+    BOOST_TEST(occurrences(trace, json_ts_name(base, "base")) == 1U);
+    BOOST_TEST(occurrences(trace, json_ts_name(far, "far")) == 1U);
+    BOOST_TEST(occurrences(trace, json_ts_name(before, "before")) == 1U);
+}
+
+//
+// Sparse events (e.g. a heartbeat) and nested complete events don't waste a chunk each, all of
+// them fit into a single chunk.
+//
+BOOST_FIXTURE_TEST_CASE(sparse_time_trace, testcase_fixture)
+{
+    using namespace ::ibis::tool::event_trace;
+
+    static constexpr std::size_t event_count = event_chunk::CHUNK_SZ / 4;
+
+    auto& trace_log = TraceLog::GetInstance();
+
+    trace_log.Flush();
+    trace_log.SetBufferMode(TraceLog::buffer_mode::FILL, event_chunk::CHUNK_SZ);
+
+    auto const base = clock::time<>::ticks();
+    auto const gap = clock::tick_type{ 1 } << 33U;  // beyond delta range
+
+    for (std::size_t i = 0; i != event_count; ++i) {
+        auto const time = base + i * gap;
+        trace_log.AddTraceEvent(TraceEvent::phase::INSTANT, "sparse_time", "heartbeat",  // --
+                                TraceID::NONE, TraceEvent::flag::NONE, time, 0,          // --
+                                "count", i);
+        // nested scopes end in reverse order of their begin
+        trace_log.AddTraceEvent(TraceEvent::phase::COMPLETE, "sparse_time", "inner",  // --
+                                TraceID::NONE, TraceEvent::flag::NONE, time + 2, 10);
+        trace_log.AddTraceEvent(TraceEvent::phase::COMPLETE, "sparse_time", "outer",  // --
+                                TraceID::NONE, TraceEvent::flag::NONE, time + 1, 20);
+    }
+
+    BOOST_TEST(trace_log.GetEventsCount() == 3 * event_count);
+
+    auto const begin = result_str().size();
+
+    trace_log.Flush();
+    trace_log.SetBufferMode(TraceLog::buffer_mode::FILL);
+
+    auto const trace = result_str().substr(begin);
+
+    BOOST_TEST(trace.find(R"("args":{"count":)" + std::to_string(event_count - 1) + "}") !=
+               std::string::npos);
+    BOOST_TEST(occurrences(trace, json_ts_name(base + gap + 1, "outer")) == 1U);
+    BOOST_TEST(occurrences(trace, json_ts_name(base + gap + 2, "inner")) == 1U);
+}
+
+//
+// The events recorded at a call site are written byte-identically to the ones without it.
+//
+BOOST_FIXTURE_TEST_CASE(trace_site_json, testcase_fixture)
+{
+    using namespace ::ibis::tool::event_trace;
+
+    auto& trace_log = TraceLog::GetInstance();
+
+    trace_log.BeginLogging();
+
+    static auto const proxy = category::get("site \"quoted\"");
+    static trace_site const site(proxy, TraceEvent::phase::INSTANT, "site event");
+    static trace_site const copy_site(proxy, TraceEvent::phase::INSTANT, TraceLog::copy("copy"));
+
+    auto const time = clock::time<>::ticks();
+    trace_log.AddTraceEvent(TraceEvent::phase::INSTANT, proxy.category_name(), "site event",  // --
+                            TraceID::NONE, TraceEvent::flag::NONE, time, 0, "answer", 42);
+    trace_log.AddTraceEvent(site, "site event",  // --
+                            TraceID::NONE, TraceEvent::flag::NONE, time, 0, "answer", 42);
+    trace_log.AddTraceEvent(site, "other event",  // --
+                            TraceID::NONE, TraceEvent::flag::NONE, time, 0);
+    trace_log.AddTraceEvent(copy_site, TraceLog::copy("copy"),  // --
+                            TraceID::NONE, TraceEvent::flag::NONE, time, 0);
+
+    trace_log.Flush();
+    trace_log.EndLogging();
+
+    auto const result = result_str();
+
+    // the site's events are written the same as without it
+    auto const first = result.find(R"({"cat":"site \"quoted\"")");
+    BOOST_REQUIRE(first != std::string::npos);
+    auto const first_end = result.find('\n', first);
+    auto const second = first_end + 1;
+    auto const second_end = result.find('\n', second);
+    BOOST_TEST(result.substr(first, first_end - first) == result.substr(second, second_end - second));
+
+    BOOST_TEST(result.find(R"("ph":"I","ts":)") != std::string::npos);
+    BOOST_TEST(result.find(R"(,"name":"other event")") != std::string::npos);
+    BOOST_TEST(result.find(R"(,"name":"copy")") != std::string::npos);
+}
+
+//
+// The events recorded at a site are flushed also after the site's destructor has run, e.g. of
+// function local statics on a flush at exit.
+//
+BOOST_FIXTURE_TEST_CASE(trace_site_destroyed, testcase_fixture)
+{
+    using namespace ::ibis::tool::event_trace;
+
+    auto& trace_log = TraceLog::GetInstance();
+
+    trace_log.BeginLogging();
+
+    static auto const proxy = category::get("site_destroyed");
+
+    // the static's storage stays, only its destructor runs
+    alignas(trace_site) static std::array<std::byte, sizeof(trace_site)> storage;
+    auto* const site = new (storage.data()) trace_site(proxy, TraceEvent::phase::INSTANT, "exit");
+
+    trace_log.AddTraceEvent(*site, "exit",  // --
+                            TraceID::NONE, TraceEvent::flag::NONE, clock::time<>::ticks(), 0);
+    site->~trace_site();
+
+    trace_log.Flush();
+    trace_log.EndLogging();
+
+    BOOST_TEST(result_str().find(R"({"cat":"site_destroyed",)") != std::string::npos);
+    BOOST_TEST(result_str().find(R"(,"name":"exit")") != std::string::npos);
+}
+
 // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
 BOOST_AUTO_TEST_SUITE_END()
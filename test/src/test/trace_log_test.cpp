@@ -11,27 +11,35 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/test/tools/output_test_stream.hpp>
 
-namespace testsuite::mock {
+#include <string>
+#include <thread>
+#include <vector>
 
-struct TraceEvent {
-    using storage_ptr = ibis::tool::event_trace::TraceEvent::storage_ptr;
-};
+namespace testsuite::mock {
 
 struct TraceLog {
     using copy = ibis::tool::event_trace::TraceLog::copy;
+    using arena = ibis::tool::event_trace::detail::arena;
+    using string_pool = ibis::tool::event_trace::detail::string_pool;
+
+    template <typename T>
+    static void intern(string_pool* pool, T& str)
+    {
+        ibis::tool::event_trace::TraceLog::intern(pool, str);
+    }
 
     template <typename T>
     static std::size_t accumulate_size(std::size_t& alloc_size, T str) {
         return ibis::tool::event_trace::TraceLog::accumulate_size(alloc_size, str);
     }
     
-    static TraceEvent::storage_ptr allocate(std::size_t alloc_size)
+    static char* allocate(arena& storage, std::size_t alloc_size)
     {
-        return ibis::tool::event_trace::TraceLog::allocate(alloc_size);
+        return ibis::tool::event_trace::TraceLog::allocate(storage, alloc_size);
     }
 
     template <typename T>
-    static void deep_copy(TraceEvent::storage_ptr& ptr, std::size_t& offset, T& str)
+    static void deep_copy(char* ptr, std::size_t& offset, T& str)
     {
         ibis::tool::event_trace::TraceLog::deep_copy(ptr, offset, str);
     }    
@@ -64,6 +72,9 @@ BOOST_AUTO_TEST_CASE(copy_marker)
     void const* const sv_ptr = as_void_ptr(sv.data());
     void const* const str_ptr = as_void_ptr(str.data());
 
+    // the chunk's string storage
+    mock::TraceLog::arena storage;
+
     // ------------------------------------------------------------------------
     // test if there is no TraceLog::copy, shall be left as is
     // ------------------------------------------------------------------------
@@ -75,7 +86,7 @@ BOOST_AUTO_TEST_CASE(copy_marker)
         mock::TraceLog::accumulate_size(alloc_size, sv);
         mock::TraceLog::accumulate_size(alloc_size, str);
 
-        mock::TraceEvent::storage_ptr ptr = mock::TraceLog::allocate(alloc_size);
+        char* const ptr = mock::TraceLog::allocate(storage, alloc_size);
 
         mock::TraceLog::deep_copy(ptr, offset, cstr);
         mock::TraceLog::deep_copy(ptr, offset, sv);
@@ -83,7 +94,8 @@ BOOST_AUTO_TEST_CASE(copy_marker)
 
         BOOST_TEST(alloc_size == 0);
         BOOST_TEST(offset == 0);
-        BOOST_TEST(!ptr);  // nullptr
+        BOOST_TEST(ptr == nullptr);
+        BOOST_TEST(storage.capacity() == 0);  // nothing allocated
 
         // still point to origin
         BOOST_TEST(as_void_ptr(cstr) == cstr_ptr);
@@ -106,14 +118,15 @@ BOOST_AUTO_TEST_CASE(copy_marker)
         mock::TraceLog::accumulate_size(alloc_size, sv_cpy);
         mock::TraceLog::accumulate_size(alloc_size, str_cpy);
 
-        mock::TraceEvent::storage_ptr ptr = mock::TraceLog::allocate(alloc_size);
+        char* const ptr = mock::TraceLog::allocate(storage, alloc_size);
 
         mock::TraceLog::deep_copy(ptr, offset, cstr_cpy);
         mock::TraceLog::deep_copy(ptr, offset, sv_cpy);
         mock::TraceLog::deep_copy(ptr, offset, str_cpy);
 
         BOOST_TEST(alloc_size == (strlen(cstr) + sv.size() + str.size() + 3));  //  3x '\0'
-        BOOST_TEST(ptr.get() != nullptr);  // something is allocated
+        BOOST_TEST(ptr != nullptr);  // something is allocated
+        BOOST_TEST(storage.capacity() >= alloc_size);
 
         // string size shall be the same ...
         BOOST_TEST(cstr_cpy.get_sv().size() == strlen(cstr));
@@ -129,7 +142,95 @@ BOOST_AUTO_TEST_CASE(copy_marker)
         BOOST_TEST(as_void_ptr(cstr_cpy.get_sv().data()) != cstr_ptr);
         BOOST_TEST(as_void_ptr(sv_cpy.get_sv().data()) != sv_ptr);
         BOOST_TEST(as_void_ptr(str_cpy.get_sv().data()) != str_ptr);
+
+        // ... which is the arena's memory
+        BOOST_TEST(as_void_ptr(cstr_cpy.get_sv().data()) == as_void_ptr(ptr));
     }
+
+    // ------------------------------------------------------------------------
+    // interned strings are copied once and don't need memory from the arena
+    // ------------------------------------------------------------------------
+    {
+        mock::TraceLog::string_pool pool;
+
+        std::string const str_1 = "Hello World";
+        std::string const str_2 = "Hello World";
+        std::string const str_long(mock::TraceLog::string_pool::MAX_STRING_SZ + 1, 'x');
+
+        mock::TraceLog::copy cpy_1(str_1);
+        mock::TraceLog::copy cpy_2(str_2);
+        mock::TraceLog::copy cpy_long(str_long);
+
+        mock::TraceLog::intern(&pool, cpy_1);
+        mock::TraceLog::intern(&pool, cpy_2);
+        mock::TraceLog::intern(&pool, cpy_long);
+
+        std::size_t alloc_size = 0;
+        mock::TraceLog::accumulate_size(alloc_size, cpy_1);
+        mock::TraceLog::accumulate_size(alloc_size, cpy_2);
+        mock::TraceLog::accumulate_size(alloc_size, cpy_long);
+
+        BOOST_TEST(alloc_size == str_long.size() + 1);  // only the long string is to be copied
+
+        BOOST_TEST(cpy_1.get_sv() == str_1);
+        BOOST_TEST(as_void_ptr(cpy_1.get_sv().data()) != as_void_ptr(str_1.data()));
+        BOOST_TEST(as_void_ptr(cpy_1.get_sv().data()) == as_void_ptr(cpy_2.get_sv().data()));
+        BOOST_TEST(as_void_ptr(cpy_long.get_sv().data()) == as_void_ptr(str_long.data()));
+    }
+
+    // ------------------------------------------------------------------------
+    // the arena's memory is reused after reset
+    // ------------------------------------------------------------------------
+    {
+        storage.reset();
+        char* const ptr_1 = storage.allocate(42);
+        storage.reset();
+        char* const ptr_2 = storage.allocate(42);
+
+        BOOST_TEST(as_void_ptr(ptr_1) == as_void_ptr(ptr_2));
+
+        // oversized blocks are released on reset
+        storage.allocate(2 * mock::TraceLog::arena::BLOCK_SZ);
+        storage.reset();
+
+        BOOST_TEST(storage.capacity() == mock::TraceLog::arena::BLOCK_SZ);
+    }
+}
+
+//
+// The string pool's size limit holds with concurrent interning of the shards.
+//
+BOOST_AUTO_TEST_CASE(string_pool_limit)
+{
+    namespace mock = testsuite::mock;
+
+    using string_pool = mock::TraceLog::string_pool;
+
+    string_pool pool;
+
+    constexpr std::size_t thread_count = 4;
+    constexpr std::size_t string_sz = string_pool::MAX_STRING_SZ - 8;
+    // each thread alone exceeds the pool's limit
+    constexpr std::size_t string_count = string_pool::MAX_POOL_SZ / (string_sz + 1) + 1;
+
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t != thread_count; ++t) {
+        threads.emplace_back([&pool, t]() {
+            std::string str(string_sz, static_cast<char>('a' + t));
+            for (std::size_t i = 0; i != string_count; ++i) {
+                auto const id = std::to_string(i);
+                str.replace(0, id.size(), id);
+                pool.intern(str);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    BOOST_TEST(pool.size() <= string_pool::MAX_POOL_SZ);
+    BOOST_TEST(pool.size() + string_sz + 1 > string_pool::MAX_POOL_SZ);
+    BOOST_TEST(pool.intern(std::string(string_sz, 'z')).data() == nullptr);
 }
 
 // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
@@ -8,8 +8,6 @@
 #include <testsuite/type_traits.hpp>
 #include <testsuite/namespace_alias.hpp>
 
-#include <ibis/util/overloaded.hpp>
-
 #include <boost/test/unit_test.hpp>
 
 #include <iomanip>
@@ -22,19 +20,17 @@ namespace std {
 
 std::ostream& operator<<(std::ostream& os, ibis::tool::event_trace::trace_value const& value)
 {
-    using ibis::util::overloaded;
-
-    std::visit(  // --
-        overloaded{
-            [&os]([[maybe_unused]] std::monostate v) { os << "trace_value<std::monostate>"; },
-            [&os]([[maybe_unused]] bool v) { os << "trace_value<bool>"; },
-            [&os]([[maybe_unused]] uint64_t v) { os << "trace_value<uint64_t>"; },
-            [&os]([[maybe_unused]] int64_t v) { os << "trace_value<int64_t>"; },
-            [&os]([[maybe_unused]] double v) { os << "trace_value<double>"; },
-            [&os]([[maybe_unused]] std::string_view sv) { os << "trace_value<std::string_view>"; },
-            [&os]([[maybe_unused]] void const* ptr) { os << "trace_value<pointer>"; },
-        },
-        value.data());
+    using type = ibis::tool::event_trace::trace_value::type;
+
+    switch (value.type_tag()) {
+        case type::NONE:    os << "trace_value<none>"; break;
+        case type::BOOL:    os << "trace_value<bool>"; break;
+        case type::UINT:    os << "trace_value<uint64_t>"; break;
+        case type::INT:     os << "trace_value<int64_t>"; break;
+        case type::DOUBLE:  os << "trace_value<double>"; break;
+        case type::STRING:  os << "trace_value<string>"; break;
+        case type::POINTER: os << "trace_value<pointer>"; break;
+    }
     return os;
 }
 
@@ -48,19 +44,23 @@ BOOST_AUTO_TEST_SUITE(common_instrumentation_utils)
 BOOST_AUTO_TEST_CASE(trace_value)
 {
     using ibis::tool::event_trace::trace_value;
+    using type = trace_value::type;
+
+    static_assert(sizeof(trace_value::payload_type) == 8);
 
     // construct them
 
     {
         trace_value null{};
         BOOST_TEST(null.empty() == true);
+        BOOST_TEST((null.type_tag() == type::NONE));
     }
     {
         trace_value boolean(true);
         BOOST_TEST(!boolean.empty() == true);
 
-        BOOST_REQUIRE_NO_THROW([[maybe_unused]] auto discard = std::get<bool>(boolean.data()));
-        BOOST_TEST(std::get<bool>(boolean.data()) == true);
+        BOOST_TEST((boolean.type_tag() == type::BOOL));
+        BOOST_TEST(boolean.get<bool>() == true);
     }
     {
         trace_value char_(char{'X'});
@@ -68,44 +68,44 @@ BOOST_AUTO_TEST_CASE(trace_value)
 
         using get_type = testsuite::util::promote_char_t<char>;
 
-        BOOST_REQUIRE_NO_THROW([[maybe_unused]] auto discard = std::get<get_type>(char_.data()));
-        BOOST_TEST(std::get<get_type>(char_.data()) == 'X');
+        BOOST_TEST((char_.type_tag() == (std::is_signed_v<char> ? type::INT : type::UINT)));
+        BOOST_TEST(char_.get<get_type>() == 'X');
     }
     {
         std::int16_t const val = 42;
         trace_value integer(val);
         BOOST_TEST(!integer.empty() == true);
 
-        BOOST_REQUIRE_NO_THROW([[maybe_unused]] auto discard = std::get<int64_t>(integer.data()));
-        BOOST_TEST(std::get<int64_t>(integer.data()) == val);
+        BOOST_TEST((integer.type_tag() == type::INT));
+        BOOST_TEST(integer.get<int64_t>() == val);
     }
     {
         trace_value integer(42);
         BOOST_TEST(!integer.empty() == true);
 
-        BOOST_REQUIRE_NO_THROW([[maybe_unused]] auto discard = std::get<int64_t>(integer.data()));
-        BOOST_TEST(std::get<int64_t>(integer.data()) == 42);
+        BOOST_TEST((integer.type_tag() == type::INT));
+        BOOST_TEST(integer.get<int64_t>() == 42);
     }
     {
         trace_value integer(42UL);
         BOOST_TEST(!integer.empty() == true);
 
-        BOOST_REQUIRE_NO_THROW([[maybe_unused]] auto discard = std::get<uint64_t>(integer.data()));
-        BOOST_TEST(std::get<uint64_t>(integer.data()) == 42);
+        BOOST_TEST((integer.type_tag() == type::UINT));
+        BOOST_TEST(integer.get<uint64_t>() == 42);
     }
     {
         trace_value integer(42ULL);
         BOOST_TEST(!integer.empty() == true);
 
-        BOOST_REQUIRE_NO_THROW([[maybe_unused]] auto discard = std::get<uint64_t>(integer.data()));
-        BOOST_TEST(std::get<uint64_t>(integer.data()) == 42);
+        BOOST_TEST((integer.type_tag() == type::UINT));
+        BOOST_TEST(integer.get<uint64_t>() == 42);
     }
     {
         trace_value real(3.14);
         BOOST_TEST(!real.empty() == true);
 
-        BOOST_REQUIRE_NO_THROW([[maybe_unused]] auto discard = std::get<double>(real.data()));
-        BOOST_TEST(std::get<double>(real.data()) == 3.14);
+        BOOST_TEST((real.type_tag() == type::DOUBLE));
+        BOOST_TEST(real.get<double>() == 3.14);
     }
     {
         std::string_view const sv = "Hello World";
@@ -113,8 +113,8 @@ BOOST_AUTO_TEST_CASE(trace_value)
         trace_value string_view(sv);
         BOOST_TEST(!string_view.empty() == true);
 
-        BOOST_REQUIRE_NO_THROW([[maybe_unused]] auto discard = std::get<char const*>(string_view.data()));
-        BOOST_TEST(std::get<char const*>(string_view.data()) == sv);
+        BOOST_TEST((string_view.type_tag() == type::STRING));
+        BOOST_TEST(string_view.get<char const*>() == sv);
     }
     {
         char const* cstr = "Hello World";
@@ -122,8 +122,8 @@ BOOST_AUTO_TEST_CASE(trace_value)
         trace_value cstring(cstr);
         BOOST_TEST(!cstring.empty() == true);
 
-        BOOST_REQUIRE_NO_THROW([[maybe_unused]] auto discard = std::get<char const*>(cstring.data()));
-        BOOST_TEST(std::get<char const*>(cstring.data()) == cstr);
+        BOOST_TEST((cstring.type_tag() == type::STRING));
+        BOOST_TEST(cstring.get<char const*>() == cstr);
     }
     {
         char const cstr[] = "Hello World";
@@ -131,8 +131,8 @@ BOOST_AUTO_TEST_CASE(trace_value)
         trace_value char_array(cstr);
         BOOST_TEST(!char_array.empty() == true);
 
-        BOOST_REQUIRE_NO_THROW([[maybe_unused]] auto discard = std::get<char const*>(char_array.data()));
-        BOOST_TEST(std::get<char const*>(char_array.data()) == cstr);
+        BOOST_TEST((char_array.type_tag() == type::STRING));
+        BOOST_TEST(char_array.get<char const*>() == cstr);
     }
     {
         int i = 42;
@@ -141,8 +141,8 @@ BOOST_AUTO_TEST_CASE(trace_value)
         trace_value pointer(ptr);
         BOOST_TEST(!pointer.empty() == true);
 
-        BOOST_REQUIRE_NO_THROW([[maybe_unused]] auto discard = std::get<void const*>(pointer.data()));
-        BOOST_TEST(std::get<void const*>(pointer.data()) == ptr);
+        BOOST_TEST((pointer.type_tag() == type::POINTER));
+        BOOST_TEST(pointer.get<void const*>() == ptr);
     }
 }
 
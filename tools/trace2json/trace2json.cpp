@@ -0,0 +1,59 @@
+//
+// Copyright (c) 2017-2022 Olaf (<ibis-hdl@users.noreply.github.com>).
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+//
+// Convert a binary trace, written by TraceLog with output_format::BINARY, into Chrome's JSON
+// trace format.
+//
+// usage: trace2json <binary trace> [<json file>]
+//
+// Without the JSON file name, the JSON is written to stdout.
+//
+
+#include <ibis/event_trace/binary_trace.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <exception>
+#include <span>
+#include <cstdlib>
+
+int main(int argc, char* argv[])
+{
+    namespace event_trace = ibis::tool::event_trace;
+
+    auto const args = std::span(argv, static_cast<std::size_t>(argc));
+
+    if (args.size() < 2 || args.size() > 3) {
+        std::cerr << "usage: " << args[0] << " <binary trace> [<json file>]\n";
+        return EXIT_FAILURE;
+    }
+
+    std::ifstream input(args[1], std::ios::binary);
+    if (!input) {
+        std::cerr << "error: can't open '" << args[1] << "'\n";
+        return EXIT_FAILURE;
+    }
+
+    try {
+        if (args.size() == 3) {
+            std::ofstream output(args[2], std::ios::binary);
+            if (!output) {
+                std::cerr << "error: can't open '" << args[2] << "'\n";
+                return EXIT_FAILURE;
+            }
+            event_trace::binary_to_json(input, output);
+        }
+        else {
+            event_trace::binary_to_json(input, std::cout);
+        }
+    }
+    catch (std::exception const& e) {
+        std::cerr << "error: " << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}